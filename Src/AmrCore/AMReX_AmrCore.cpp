@@ -129,6 +129,34 @@ AmrCore::regrid (int lbase, Real time, bool)
     finest_level = new_finest;
 }
 
+bool
+AmrCore::rebalance (int lev, Real time, const Vector<Real>& box_costs, Real threshold)
+{
+    BL_PROFILE("AmrCore::rebalance()");
+
+    AMREX_ALWAYS_ASSERT(lev <= finest_level && box_costs.size() == grids[lev].size());
+
+    const Real old_imbalance = dmap[lev].computeImbalance(box_costs);
+    if (old_imbalance <= threshold) return false;
+
+    DistributionMapping new_dmap = DistributionMapping::makeBalanced(box_costs, grids[lev]);
+    const Real new_imbalance = new_dmap.computeImbalance(box_costs);
+
+    if (verbose > 0) {
+        amrex::Print() << "AmrCore::rebalance: level " << lev << " imbalance "
+                       << old_imbalance << " -> " << new_imbalance << "\n";
+    }
+
+    if (new_imbalance >= old_imbalance) return false;
+
+    const auto old_num_setdm = num_setdm;
+    RemakeLevel(lev, time, grids[lev], new_dmap);
+    if (old_num_setdm == num_setdm) {
+        SetDistributionMap(lev, new_dmap);
+    }
+
+    return true;
+}
 
 void
 AmrCore::printGridSummary (std::ostream& os, int min_lev, int max_lev) const noexcept
@@ -4,6 +4,7 @@
 #include <AMReX_CArena.H>
 #include <AMReX_DArena.H>
 #include <AMReX_EArena.H>
+#include <AMReX_SArena.H>
 
 #include <AMReX.H>
 #include <AMReX_Print.H>
@@ -23,11 +24,13 @@ namespace {
     Arena* the_managed_arena = nullptr;
     Arena* the_pinned_arena = nullptr;
     Arena* the_cpu_arena = nullptr;
+    Arena* the_shared_arena = nullptr;
 
     bool use_buddy_allocator = false;
     long buddy_allocator_size = 0L;
     long the_arena_init_size = 0L;
     bool abort_on_out_of_gpu_memory = false;
+    long shared_arena_size = 0L;
 }
 
 const std::size_t Arena::align_size;
@@ -130,12 +133,14 @@ Arena::Initialize ()
     BL_ASSERT(the_managed_arena == nullptr);
     BL_ASSERT(the_pinned_arena == nullptr);
     BL_ASSERT(the_cpu_arena == nullptr);
+    BL_ASSERT(the_shared_arena == nullptr);
 
     ParmParse pp("amrex");
     pp.query("use_buddy_allocator", use_buddy_allocator);
     pp.query("buddy_allocator_size", buddy_allocator_size);
     pp.query("the_arena_init_size", the_arena_init_size);
     pp.query("abort_on_out_of_gpu_memory", abort_on_out_of_gpu_memory);
+    pp.query("shared_arena_size", shared_arena_size);
 
 #ifdef AMREX_USE_GPU
     if (use_buddy_allocator)
@@ -192,6 +197,12 @@ Arena::Initialize ()
     the_pinned_arena->free(p);
 
     the_cpu_arena = new BArena;
+
+#if defined(BL_USE_MPI) && (MPI_VERSION >= 3) && !defined(AMREX_USE_GPU)
+    if (shared_arena_size > 0) {
+        the_shared_arena = new SArena(shared_arena_size);
+    }
+#endif
 }
 
 void
@@ -225,6 +236,16 @@ Arena::PrintUsage ()
     }
 #endif
     if (The_Arena()) {
+        long min_nallocs = The_Arena()->numAllocs();
+        long max_nallocs = min_nallocs;
+        ParallelDescriptor::ReduceLongMin(min_nallocs, IOProc);
+        ParallelDescriptor::ReduceLongMax(max_nallocs, IOProc);
+#ifdef AMREX_USE_MPI
+        amrex::Print() << "[The         Arena] number of allocations spread across MPI: ["
+                       << min_nallocs << " ... " << max_nallocs << "]\n";
+#else
+        amrex::Print() << "[The         Arena] number of allocations: " << min_nallocs << "\n";
+#endif
         CArena* p = dynamic_cast<CArena*>(The_Arena());
         if (p) {
             long min_megabytes = p->heap_space_used() / (1024*1024);
@@ -309,6 +330,9 @@ Arena::Finalize ()
 
     delete the_cpu_arena;
     the_cpu_arena = nullptr;
+
+    delete the_shared_arena;
+    the_shared_arena = nullptr;
 }
     
 Arena*
@@ -346,4 +370,10 @@ The_Cpu_Arena ()
     return the_cpu_arena;
 }
 
+Arena*
+The_Shared_Arena ()
+{
+    return the_shared_arena;
+}
+
 }
@@ -0,0 +1,136 @@
+#include <AMReX_AsyncOut.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX.H>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace amrex {
+namespace AsyncOut {
+
+namespace {
+    bool initialized = false;
+
+    int         nthreads = 1;
+    std::size_t max_bytes = 0;
+
+    std::vector<std::thread> workers;
+    std::deque<std::pair<std::function<void()>,std::size_t> > tasks;
+    std::mutex mutex;
+    std::condition_variable task_cv;   // a task is queued, or shutdown
+    std::condition_variable done_cv;   // a task has finished
+    std::size_t held_bytes = 0;
+    int  nrunning = 0;
+    bool shutdown = false;
+
+    void worker ()
+    {
+        while (true)
+        {
+            std::pair<std::function<void()>,std::size_t> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                task_cv.wait(lock, [] () { return shutdown || !tasks.empty(); });
+                if (tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                ++nrunning;
+            }
+
+            task.first();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --nrunning;
+                held_bytes -= task.second;
+            }
+            done_cv.notify_all();
+        }
+    }
+}
+
+void
+Initialize ()
+{
+    if (initialized) return;
+    initialized = true;
+
+    nthreads = 1;
+    max_bytes = 0;
+    shutdown = false;
+
+    ParmParse pp("amrex");
+    pp.query("async_out_nthreads", nthreads);
+    nthreads = std::max(nthreads, 1);
+    long mb = 0;
+    pp.query("async_out_max_bytes", mb);
+    max_bytes = static_cast<std::size_t>(std::max(mb, 0L));
+
+    amrex::ExecOnFinalize(AsyncOut::Finalize);
+}
+
+void
+Finalize ()
+{
+    if (!initialized) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shutdown = true;
+    }
+    task_cv.notify_all();
+    // The workers run the remaining tasks before they return.
+    for (auto& t : workers) {
+        t.join();
+    }
+    workers.clear();
+    held_bytes = 0;
+
+    initialized = false;
+}
+
+void
+Reserve (std::size_t nbytes)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (max_bytes > 0) {
+        done_cv.wait(lock, [=] () { return held_bytes == 0 || held_bytes + nbytes <= max_bytes; });
+    }
+    held_bytes += nbytes;
+}
+
+void
+Submit (std::function<void()>&& task, std::size_t nbytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // The threads are started lazily.
+        while (static_cast<int>(workers.size()) < nthreads) {
+            workers.emplace_back(worker);
+        }
+        tasks.emplace_back(std::move(task), nbytes);
+    }
+    task_cv.notify_one();
+}
+
+void
+Wait ()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [] () { return tasks.empty() && nrunning == 0; });
+}
+
+std::size_t
+HeldBytes ()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return held_bytes;
+}
+
+}
+}
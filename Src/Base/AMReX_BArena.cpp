@@ -3,6 +3,7 @@
 void*
 amrex::BArena::alloc (std::size_t sz_)
 {
+    ++m_num_allocs;
     return std::malloc(sz_);
 }
 
@@ -63,6 +63,8 @@ DArena::alloc (std::size_t nbytes)
 {
     if (nbytes == 0) return nullptr; // behavior different from the standard
 
+    ++m_num_allocs;
+
     // We need to allocate this many blocks
     unsigned int nblocks = (nbytes+m_block_size-1)/m_block_size;
 
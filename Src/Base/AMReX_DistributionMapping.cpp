@@ -10,6 +10,7 @@
 #endif
 #include <AMReX_VisMF.H>
 #include <AMReX_Utility.H>
+#include <AMReX_Machine.H>
 
 #include <iostream>
 #include <fstream>
@@ -23,9 +24,14 @@
 #include <string>
 #include <cstring>
 #include <iomanip>
+#include <set>
 
 namespace {
 int flag_verbose_mapper;
+int graph_nghost;
+amrex::Real graph_tolerance;
+int report_strategies;
+int topology_aware;
 }
 
 namespace amrex {
@@ -75,6 +81,12 @@ DistributionMapping::strategy (DistributionMapping::Strategy how)
     case RRSFC:
         m_BuildMap = &DistributionMapping::RRSFCProcessorMap;
         break;
+    case HILBERT:
+        m_BuildMap = &DistributionMapping::HilbertProcessorMap;
+        break;
+    case GRAPH:
+        m_BuildMap = &DistributionMapping::GraphProcessorMap;
+        break;
     default:
         amrex::Error("Bad DistributionMapping::Strategy");
     }
@@ -116,6 +128,10 @@ DistributionMapping::Initialize ()
     max_efficiency   = 0.9;
     node_size        = 0;
     flag_verbose_mapper = 0;
+    graph_nghost     = 1;
+    graph_tolerance  = 0.05;
+    report_strategies = 0;
+    topology_aware   = 0;
 
     ParmParse pp("DistributionMapping");
 
@@ -125,6 +141,10 @@ DistributionMapping::Initialize ()
     pp.query("sfc_threshold",       sfc_threshold);
     pp.query("node_size",           node_size);
     pp.query("verbose_mapper",      flag_verbose_mapper);
+    pp.query("graph_nghost",        graph_nghost);
+    pp.query("graph_tolerance",     graph_tolerance);
+    pp.query("report_strategies",   report_strategies);
+    pp.query("topology_aware",      topology_aware);
 
     std::string theStrategy;
 
@@ -146,6 +166,14 @@ DistributionMapping::Initialize ()
         {
             strategy(RRSFC);
         }
+        else if (theStrategy == "HILBERT")
+        {
+            strategy(HILBERT);
+        }
+        else if (theStrategy == "GRAPH")
+        {
+            strategy(GRAPH);
+        }
         else
         {
             std::string msg("Unknown strategy: ");
@@ -345,6 +373,15 @@ DistributionMapping::define (const BoxArray& boxes,
     BL_ASSERT(m_BuildMap != 0);
 
     (this->*m_BuildMap)(boxes,nprocs);
+
+    if (report_strategies && boxes.size() > 0)
+    {
+        std::vector<long> wgts(boxes.size());
+        for (int i = 0, N = boxes.size(); i < N; ++i) {
+            wgts[i] = boxes[i].numPts();
+        }
+        ReportStrategies(boxes, wgts, graph_nghost);
+    }
 }
 
 void
@@ -917,6 +954,130 @@ SFCToken::Compare::operator () (const SFCToken& lhs,
     return false;
 }
 
+namespace
+{
+    //
+    // Replace the coordinates with the "transposed" Hilbert index using
+    // Skilling's algorithm (AIP Conf. Proc. 707, 381 (2004)).
+    //
+    void
+    AxesToTranspose (unsigned int* X, int b)
+    {
+        const unsigned int M = 1u << (b-1);
+        for (unsigned int Q = M; Q > 1; Q >>= 1)
+        {
+            const unsigned int P = Q - 1;
+            for (int i = 0; i < AMREX_SPACEDIM; ++i)
+            {
+                if (X[i] & Q) {
+                    X[0] ^= P;
+                } else {
+                    const unsigned int t = (X[0] ^ X[i]) & P;
+                    X[0] ^= t;
+                    X[i] ^= t;
+                }
+            }
+        }
+        for (int i = 1; i < AMREX_SPACEDIM; ++i) {
+            X[i] ^= X[i-1];
+        }
+        unsigned int t = 0;
+        for (unsigned int Q = M; Q > 1; Q >>= 1) {
+            if (X[AMREX_SPACEDIM-1] & Q) t ^= Q - 1;
+        }
+        for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+            X[i] ^= t;
+        }
+    }
+
+    //
+    // Put the tokens in Hilbert space filling curve order.  Unlike the
+    // Morton order consecutive boxes on the curve are always face
+    // neighbors for a uniform grid, so contiguous chunks of the curve
+    // have fewer neighbors on other processes.
+    //
+    void
+    HilbertSort (std::vector<SFCToken>& tokens)
+    {
+        if (tokens.empty()) return;
+
+        IntVect lo = tokens[0].m_idx;
+        for (const SFCToken& tok : tokens) {
+            lo.min(tok.m_idx);
+        }
+
+        int maxijk = 0;
+        for (const SFCToken& tok : tokens) {
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                maxijk = std::max(maxijk, tok.m_idx[d]-lo[d]);
+            }
+        }
+
+        int nbits = 1;
+        for ( ; (1L << nbits) <= maxijk; ++nbits) {
+            ;  // do nothing
+        }
+        // The key has to fit into 64 bits.
+        const int maxbits = 63/AMREX_SPACEDIM;
+        const int shift = std::max(0, nbits-maxbits);
+        nbits = std::min(nbits, maxbits);
+
+        std::vector<std::pair<unsigned long long,int> > keys;
+        keys.reserve(tokens.size());
+
+        for (int k = 0, N = tokens.size(); k < N; ++k)
+        {
+            unsigned int X[AMREX_SPACEDIM];
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                X[d] = static_cast<unsigned int>(tokens[k].m_idx[d]-lo[d]) >> shift;
+            }
+
+            AxesToTranspose(X, nbits);
+
+            unsigned long long key = 0;
+            for (int b = nbits-1; b >= 0; --b) {
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    key = (key << 1) | ((X[d] >> b) & 1u);
+                }
+            }
+            keys.push_back(std::make_pair(key,k));
+        }
+
+        std::sort(keys.begin(), keys.end());
+
+        std::vector<SFCToken> sorted;
+        sorted.reserve(tokens.size());
+        for (const auto& kv : keys) {
+            sorted.push_back(tokens[kv.second]);
+        }
+        tokens.swap(sorted);
+    }
+}
+
+//
+// Local ranks ordered by node, NUMA domain and rank, so that consecutive
+// chunks of a space filling curve end up close to each other.
+//
+static
+Vector<int>
+TopologyOrder (int nprocs)
+{
+    const Vector<int>& node_ids = machine::node_ids();
+    const Vector<int>& numa_ids = machine::numa_ids();
+
+    Vector<int> ord(nprocs);
+    std::iota(ord.begin(), ord.end(), 0);
+    std::stable_sort(ord.begin(), ord.end(),
+                     [&] (int a, int b)
+                     {
+                         const int ga = ParallelContext::local_to_global_rank(a);
+                         const int gb = ParallelContext::local_to_global_rank(b);
+                         return std::make_pair(node_ids[ga],numa_ids[ga])
+                             <  std::make_pair(node_ids[gb],numa_ids[gb]);
+                     });
+    return ord;
+}
+
 static
 void
 Distribute (const std::vector<SFCToken>&     tokens,
@@ -1004,8 +1165,9 @@ Distribute (const std::vector<SFCToken>&     tokens,
 void
 DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
                                           const std::vector<long>& wgts,
-                                          int                   /*   nprocs */,
-                                          bool                     sort)
+                                          int                      nprocs,
+                                          bool                     sort,
+                                          bool                     hilbert)
 {
     if (flag_verbose_mapper) {
         Print() << "DM: SFCProcessorMapDoIt called..." << std::endl;
@@ -1013,8 +1175,6 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
 
     BL_PROFILE("DistributionMapping::SFCProcessorMapDoIt()");
 
-    int nprocs = ParallelContext::NProcsSub();
-
     int nteams = nprocs;
     int nworkers = 1;
 #if defined(BL_USE_TEAM)
@@ -1064,9 +1224,13 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
     }
     SFCToken::MaxPower = m;
     //
-    // Put'm in Morton space filling curve order.
+    // Put'm in Hilbert or Morton space filling curve order.
     //
-    std::sort(tokens.begin(), tokens.end(), SFCToken::Compare());
+    if (hilbert) {
+        HilbertSort(tokens);
+    } else {
+        std::sort(tokens.begin(), tokens.end(), SFCToken::Compare());
+    }
     //
     // Split'm up as equitably as possible per team.
     //
@@ -1098,7 +1262,11 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
         LIpairV.push_back(LIpair(wgt,i));
     }
 
-    if (sort) Sort(LIpairV, true);
+    // With topology_aware, the buckets stay in curve order so that
+    // neighboring buckets are placed on the same node.
+    const bool topo = topology_aware && nteams == nprocs;
+
+    if (sort && !topo) Sort(LIpairV, true);
 
     if (flag_verbose_mapper) {
         for (const auto &p : LIpairV) {
@@ -1113,7 +1281,9 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
     Vector<int> ord;
     Vector<Vector<int> > wrkerord;
 
-    if (nteams == nprocs) {
+    if (topo) {
+        ord = TopologyOrder(nprocs);
+    } else if (nteams == nprocs) {
         if (sort) {
             LeastUsedCPUs(nprocs,ord);
         } else {
@@ -1327,6 +1497,411 @@ DistributionMapping::RRSFCProcessorMap (const BoxArray&          boxes,
     RRSFCDoIt(boxes,nprocs);
 }
 
+void
+DistributionMapping::HilbertProcessorMap (const BoxArray& boxes,
+                                          int             nprocs)
+{
+    std::vector<long> wgts;
+
+    wgts.reserve(boxes.size());
+
+    for (int i = 0, N = boxes.size(); i < N; ++i)
+    {
+        wgts.push_back(boxes[i].volume());
+    }
+
+    HilbertProcessorMap(boxes,wgts,nprocs);
+}
+
+void
+DistributionMapping::HilbertProcessorMap (const BoxArray&          boxes,
+                                          const std::vector<long>& wgts,
+                                          int                      nprocs,
+                                          bool                     sort)
+{
+    BL_ASSERT(boxes.size() > 0);
+    BL_ASSERT(boxes.size() == static_cast<int>(wgts.size()));
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(wgts.size());
+
+    if (boxes.size() < sfc_threshold*nprocs)
+    {
+        KnapSackProcessorMap(wgts,nprocs);
+    }
+    else
+    {
+        SFCProcessorMapDoIt(boxes,wgts,nprocs,sort,true);
+    }
+}
+
+void
+DistributionMapping::GraphDoIt (const BoxArray&          boxes,
+                                const std::vector<long>& wgts,
+                                int                      nprocs)
+{
+    BL_PROFILE("DistributionMapping::GraphDoIt()");
+
+    const int N = boxes.size();
+    //
+    // Start from contiguous chunks of the Hilbert curve.
+    //
+    std::vector<SFCToken> tokens;
+    tokens.reserve(N);
+    Real volpercpu = 0;
+    for (int i = 0; i < N; ++i)
+    {
+        const Box& bx = boxes[i];
+        tokens.push_back(SFCToken(i,bx.smallEnd(),wgts[i]));
+        volpercpu += wgts[i];
+    }
+    volpercpu /= nprocs;
+
+    HilbertSort(tokens);
+
+    std::vector< std::vector<int> > vec(nprocs);
+
+    Distribute(tokens,nprocs,volpercpu,vec);
+
+    std::vector<int>  part(N);
+    std::vector<long> load(nprocs,0);
+    std::vector<int>  count(nprocs,0);
+    for (int p = 0; p < nprocs; ++p)
+    {
+        for (int i : vec[p])
+        {
+            part[i] = p;
+            load[p] += wgts[i];
+            ++count[p];
+        }
+    }
+    //
+    // The graph has an edge between two boxes if one of them is in the
+    // other's ghost region.  The edge weight is the number of ghost cells
+    // the two boxes exchange in FillBoundary.
+    //
+    std::vector< std::vector< std::pair<int,long> > > adj(N);
+    std::vector< std::pair<int,Box> > isects;
+    for (int i = 0; i < N; ++i)
+    {
+        boxes.intersections(amrex::grow(boxes[i],graph_nghost), isects);
+        for (const auto& is : isects)
+        {
+            const int j = is.first;
+            if (j != i)
+            {
+                const long w = is.second.numPts();
+                adj[i].push_back(std::make_pair(j,w));
+                adj[j].push_back(std::make_pair(i,w));
+            }
+        }
+    }
+
+    auto cut_volume = [&] () -> long
+    {
+        long cut = 0;
+        for (int i = 0; i < N; ++i) {
+            for (const auto& e : adj[i]) {
+                if (part[e.first] != part[i]) cut += e.second;
+            }
+        }
+        return cut/2;
+    };
+
+    const long cut0 = (verbose) ? cut_volume() : 0L;
+    //
+    // Greedy boundary refinement: move a box to the neighboring process
+    // it shares the most ghost cells with, as long as this reduces the cut
+    // and the load of the receiving process stays within the tolerance.
+    //
+    const long avgload = static_cast<long>(volpercpu);
+    const long maxload = std::max(static_cast<long>((1.0+graph_tolerance)*volpercpu),
+                                  *std::max_element(load.begin(), load.end()));
+
+    std::map<int,long> conn;
+    int nmoves = 0;
+    const int max_passes = 4;
+    for (int pass = 0; pass < max_passes; ++pass)
+    {
+        int moved = 0;
+        for (const SFCToken& tok : tokens)
+        {
+            const int i = tok.m_box;
+            const int pi = part[i];
+
+            if (count[pi] <= 1 || adj[i].empty()) continue;
+
+            conn.clear();
+            for (const auto& e : adj[i]) {
+                conn[part[e.first]] += e.second;
+            }
+
+            const long internal = conn[pi];
+            long best_gain = 0;
+            int  best = -1;
+            for (const auto& c : conn)
+            {
+                const int q = c.first;
+                const long gain = c.second - internal;
+                if (q != pi && gain > best_gain && load[q]+wgts[i] <= maxload)
+                {
+                    best_gain = gain;
+                    best = q;
+                }
+            }
+
+            if (best >= 0)
+            {
+                part[i] = best;
+                load[pi] -= wgts[i];
+                load[best] += wgts[i];
+                --count[pi];
+                ++count[best];
+                ++moved;
+            }
+        }
+        nmoves += moved;
+        if (moved == 0) break;
+    }
+
+    Vector<int> ord(nprocs);
+    if (topology_aware) {
+        ord = TopologyOrder(nprocs);
+    } else {
+        std::iota(ord.begin(), ord.end(), 0);
+    }
+
+    for (int i = 0; i < N; ++i)
+    {
+        m_ref->m_pmap[i] = ParallelContext::local_to_global_rank(ord[part[i]]);
+    }
+
+    if (verbose)
+    {
+        const long maxwgt = *std::max_element(load.begin(), load.end());
+        amrex::Print() << "GRAPH efficiency: " << Real(avgload)/Real(maxwgt)
+                       << ", moved " << nmoves << " boxes, ghost cells cut: "
+                       << cut0 << " -> " << cut_volume() << '\n';
+    }
+}
+
+void
+DistributionMapping::GraphProcessorMap (const BoxArray& boxes,
+                                        int             nprocs)
+{
+    std::vector<long> wgts;
+
+    wgts.reserve(boxes.size());
+
+    for (int i = 0, N = boxes.size(); i < N; ++i)
+    {
+        wgts.push_back(boxes[i].volume());
+    }
+
+    GraphProcessorMap(boxes,wgts,nprocs);
+}
+
+void
+DistributionMapping::GraphProcessorMap (const BoxArray&          boxes,
+                                        const std::vector<long>& wgts,
+                                        int                      nprocs)
+{
+    BL_ASSERT(boxes.size() > 0);
+    BL_ASSERT(boxes.size() == static_cast<int>(wgts.size()));
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(wgts.size());
+
+    if (boxes.size() < sfc_threshold*nprocs)
+    {
+        KnapSackProcessorMap(wgts,nprocs);
+    }
+    else
+    {
+        GraphDoIt(boxes,wgts,nprocs);
+    }
+}
+
+DistributionMapping::MapStats
+DistributionMapping::computeStats (const BoxArray&          boxes,
+                                   const std::vector<long>& wgts,
+                                   int                      nghost) const
+{
+    BL_PROFILE("DistributionMapping::computeStats()");
+
+    BL_ASSERT(boxes.size() == static_cast<int>(wgts.size()));
+    BL_ASSERT(boxes.size() == size());
+
+    const Vector<int>& pmap = ProcessorMap();
+    const int N = boxes.size();
+    const int nprocs = ParallelContext::NProcsSub();
+
+    const Vector<int>& node_ids = machine::node_ids();
+
+    std::map<int,long> load, recv;
+    std::map<int,std::set<int> > srcs;
+
+    MapStats stats;
+
+    std::vector< std::pair<int,Box> > isects;
+    for (int i = 0; i < N; ++i)
+    {
+        const int pi = pmap[i];
+        load[pi] += wgts[i];
+
+        boxes.intersections(amrex::grow(boxes[i],nghost), isects);
+        for (const auto& is : isects)
+        {
+            const int pj = pmap[is.first];
+            if (pj != pi)
+            {
+                const long npts = is.second.numPts();
+                stats.comm_volume += npts;
+                if (node_ids[pi] != node_ids[pj]) {
+                    stats.inter_node_volume += npts;
+                }
+                recv[pi] += npts;
+                srcs[pi].insert(pj);
+            }
+        }
+    }
+
+    long sum_wgt = 0, max_wgt = 0;
+    for (const auto& kv : load)
+    {
+        sum_wgt += kv.second;
+        max_wgt = std::max(max_wgt, kv.second);
+    }
+    for (const auto& kv : recv) {
+        stats.max_comm_volume = std::max(stats.max_comm_volume, kv.second);
+    }
+    for (const auto& kv : srcs) {
+        stats.max_neighbors = std::max(stats.max_neighbors, static_cast<long>(kv.second.size()));
+    }
+
+    if (max_wgt > 0)
+    {
+        const Real avg_wgt = Real(sum_wgt)/Real(nprocs);
+        stats.efficiency = avg_wgt/Real(max_wgt);
+        stats.imbalance  = Real(max_wgt)/avg_wgt;
+    }
+
+    return stats;
+}
+
+void
+DistributionMapping::ReportStrategies (const BoxArray&          boxes,
+                                       const std::vector<long>& wgts,
+                                       int                      nghost)
+{
+    BL_PROFILE("DistributionMapping::ReportStrategies()");
+
+    const int nprocs = ParallelContext::NProcsSub();
+
+    const std::vector<std::pair<Strategy,std::string> > strategies
+        { {ROUNDROBIN, "ROUNDROBIN"}, {KNAPSACK, "KNAPSACK"}, {SFC,   "SFC"},
+          {RRSFC,      "RRSFC"},      {HILBERT,  "HILBERT"},  {GRAPH, "GRAPH"} };
+
+    amrex::Print() << "DistributionMapping strategies for " << boxes.size()
+                   << " boxes on " << nprocs << " processes, nghost = " << nghost
+                   << ", bytes per component:\n"
+                   << "  " << std::setw(10) << std::left << "strategy" << std::right
+                   << std::setw(12) << "efficiency"
+                   << std::setw(12) << "imbalance"
+                   << std::setw(16) << "comm volume"
+                   << std::setw(16) << "max recv vol"
+                   << std::setw(14) << "max nbrs"
+                   << std::setw(16) << "intra bytes"
+                   << std::setw(16) << "inter bytes" << '\n';
+
+    for (const auto& s : strategies)
+    {
+        DistributionMapping dm;
+        dm.m_ref->m_pmap.resize(boxes.size());
+
+        switch (s.first)
+        {
+        case ROUNDROBIN:
+            dm.RoundRobinProcessorMap(wgts,nprocs);
+            break;
+        case KNAPSACK:
+            dm.KnapSackProcessorMap(wgts,nprocs);
+            break;
+        case SFC:
+            dm.SFCProcessorMap(boxes,wgts,nprocs);
+            break;
+        case RRSFC:
+            dm.RRSFCProcessorMap(boxes,nprocs);
+            break;
+        case HILBERT:
+            dm.HilbertProcessorMap(boxes,wgts,nprocs);
+            break;
+        case GRAPH:
+            dm.GraphProcessorMap(boxes,wgts,nprocs);
+            break;
+        default:
+            amrex::Error("Bad DistributionMapping::Strategy");
+        }
+
+        const MapStats stats = dm.computeStats(boxes,wgts,nghost);
+
+        amrex::Print() << "  " << std::setw(10) << std::left << s.second << std::right
+                       << std::setw(12) << std::setprecision(4) << stats.efficiency
+                       << std::setw(12) << std::setprecision(4) << stats.imbalance
+                       << std::setw(16) << stats.comm_volume
+                       << std::setw(16) << stats.max_comm_volume
+                       << std::setw(14) << stats.max_neighbors
+                       << std::setw(16) << (stats.comm_volume-stats.inter_node_volume)*sizeof(Real)
+                       << std::setw(16) << stats.inter_node_volume*sizeof(Real) << '\n';
+    }
+}
+
+namespace
+{
+    //
+    // The costs scaled to integers in [1, 1e9+1], as the strategies expect.
+    //
+    Vector<long>
+    scale_weights (const Vector<Real>& rcost)
+    {
+        Vector<long> cost(rcost.size());
+
+        Real wmax = rcost.empty() ? 0.0 : *std::max_element(rcost.begin(), rcost.end());
+        Real scale = (wmax == 0) ? 1.e9 : 1.e9/wmax;
+
+        for (int i = 0; i < rcost.size(); ++i) {
+            cost[i] = long(rcost[i]*scale) + 1L;
+        }
+
+        return cost;
+    }
+
+    //
+    // Sum of the weight over each box, scaled to integers.  This is shared
+    // by all the strategies that take a weight MultiFab.
+    //
+    Vector<long>
+    gather_weights (const MultiFab& weight)
+    {
+#ifdef BL_USE_MPI
+        Vector<Real> rcost(weight.size(), 0.0);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(weight); mfi.isValid(); ++mfi) {
+            int i = mfi.index();
+            rcost[i] = weight[mfi].sum(mfi.validbox(),0);
+        }
+
+        ParallelAllReduce::Sum(&rcost[0], rcost.size(), ParallelContext::CommunicatorSub());
+
+        return scale_weights(rcost);
+#else
+        return Vector<long>(weight.size());
+#endif
+    }
+}
+
 DistributionMapping
 DistributionMapping::makeKnapSack (const Vector<Real>& rcost)
 {
@@ -1334,14 +1909,7 @@ DistributionMapping::makeKnapSack (const Vector<Real>& rcost)
 
     DistributionMapping r;
 
-    Vector<long> cost(rcost.size());
-
-    Real wmax = *std::max_element(rcost.begin(), rcost.end());
-    Real scale = (wmax == 0) ? 1.e9 : 1.e9/wmax;
-
-    for (int i = 0; i < rcost.size(); ++i) {
-        cost[i] = long(rcost[i]*scale) + 1L;
-    }
+    Vector<long> cost = scale_weights(rcost);
 
     int nprocs = ParallelContext::NProcsSub();
     Real eff;
@@ -1358,28 +1926,7 @@ DistributionMapping::makeKnapSack (const MultiFab& weight, int nmax)
 
     DistributionMapping r;
 
-    Vector<long> cost(weight.size());
-#ifdef BL_USE_MPI
-    {
-	Vector<Real> rcost(cost.size(), 0.0);
-#ifdef _OPENMP
-#pragma omp parallel
-#endif
-	for (MFIter mfi(weight); mfi.isValid(); ++mfi) {
-	    int i = mfi.index();
-	    rcost[i] = weight[mfi].sum(mfi.validbox(),0);
-	}
-
-	ParallelAllReduce::Sum(&rcost[0], rcost.size(), ParallelContext::CommunicatorSub());
-
-	Real wmax = *std::max_element(rcost.begin(), rcost.end());
-	Real scale = (wmax == 0) ? 1.e9 : 1.e9/wmax;
-
-	for (int i = 0; i < rcost.size(); ++i) {
-	    cost[i] = long(rcost[i]*scale) + 1L;
-	}
-    }
-#endif
+    Vector<long> cost = gather_weights(weight);
 
     int nprocs = ParallelContext::NProcsSub();
     Real eff;
@@ -1394,71 +1941,113 @@ DistributionMapping::makeRoundRobin (const MultiFab& weight)
 {
     DistributionMapping r;
 
-    Vector<long> cost(weight.size());
-#ifdef BL_USE_MPI
-    {
-	Vector<Real> rcost(cost.size(), 0.0);
-#ifdef _OPENMP
-#pragma omp parallel
-#endif
-	for (MFIter mfi(weight); mfi.isValid(); ++mfi) {
-	    int i = mfi.index();
-	    rcost[i] = weight[mfi].sum(mfi.validbox(),0);
-	}
+    Vector<long> cost = gather_weights(weight);
 
-	ParallelAllReduce::Sum(&rcost[0], rcost.size(), ParallelContext::CommunicatorSub());
+    int nprocs = ParallelContext::NProcsSub();
 
-	Real wmax = *std::max_element(rcost.begin(), rcost.end());
-        Real scale = (wmax == 0) ? 1.e9 : 1.e9/wmax;
+    r.RoundRobinProcessorMap(cost, nprocs);
 
-	for (int i = 0; i < rcost.size(); ++i) {
-	    cost[i] = long(rcost[i]*scale) + 1L;
-	}
-    }
-#endif
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makeSFC (const MultiFab& weight, bool sort)
+{
+    DistributionMapping r;
+
+    Vector<long> cost = gather_weights(weight);
 
     int nprocs = ParallelContext::NProcsSub();
 
-    r.RoundRobinProcessorMap(cost, nprocs);
+    r.SFCProcessorMap(weight.boxArray(), cost, nprocs, sort);
 
     return r;
 }
 
 DistributionMapping
-DistributionMapping::makeSFC (const MultiFab& weight, bool sort)
+DistributionMapping::makeHilbert (const MultiFab& weight, bool sort)
 {
     DistributionMapping r;
 
-    Vector<long> cost(weight.size());
-#ifdef BL_USE_MPI
-    {
-	Vector<Real> rcost(cost.size(), 0.0);
-#ifdef _OPENMP
-#pragma omp parallel
-#endif
-	for (MFIter mfi(weight); mfi.isValid(); ++mfi) {
-	    int i = mfi.index();
-	    rcost[i] = weight[mfi].sum(mfi.validbox(),0);
-	}
+    Vector<long> cost = gather_weights(weight);
 
-	ParallelAllReduce::Sum(&rcost[0], rcost.size(), ParallelContext::CommunicatorSub());
+    int nprocs = ParallelContext::NProcsSub();
 
-	Real wmax = *std::max_element(rcost.begin(), rcost.end());
-        Real scale = (wmax == 0) ? 1.e9 : 1.e9/wmax;
+    r.HilbertProcessorMap(weight.boxArray(), cost, nprocs, sort);
 
-	for (int i = 0; i < rcost.size(); ++i) {
-	    cost[i] = long(rcost[i]*scale) + 1L;
-	}
-    }
-#endif
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makeGraph (const MultiFab& weight)
+{
+    DistributionMapping r;
+
+    Vector<long> cost = gather_weights(weight);
 
     int nprocs = ParallelContext::NProcsSub();
 
-    r.SFCProcessorMap(weight.boxArray(), cost, nprocs, sort);
+    r.GraphProcessorMap(weight.boxArray(), cost, nprocs);
 
     return r;
 }
 
+DistributionMapping
+DistributionMapping::makeBalanced (const Vector<Real>& rcost, const BoxArray& ba)
+{
+    BL_PROFILE("makeBalanced");
+
+    BL_ASSERT(rcost.size() == ba.size());
+
+    DistributionMapping r;
+
+    Vector<long> cost = scale_weights(rcost);
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    switch (m_Strategy)
+    {
+    case ROUNDROBIN:
+        r.RoundRobinProcessorMap(cost, nprocs);
+        break;
+    case KNAPSACK:
+        r.KnapSackProcessorMap(cost, nprocs);
+        break;
+    case HILBERT:
+        r.HilbertProcessorMap(ba, cost, nprocs);
+        break;
+    case GRAPH:
+        r.GraphProcessorMap(ba, cost, nprocs);
+        break;
+    default:
+        r.SFCProcessorMap(ba, cost, nprocs);
+    }
+
+    return r;
+}
+
+Real
+DistributionMapping::computeImbalance (const Vector<Real>& rcost) const
+{
+    BL_ASSERT(rcost.size() == size());
+
+    const Vector<int>& pmap = ProcessorMap();
+    const int nprocs = ParallelContext::NProcsSub();
+
+    Vector<Real> load(nprocs, 0.0);
+    for (int i = 0; i < rcost.size(); ++i) {
+        load[pmap[i]] += rcost[i];
+    }
+
+    Real sum_load = 0.0, max_load = 0.0;
+    for (const auto& l : load) {
+        sum_load += l;
+        max_load = std::max(max_load, l);
+    }
+
+    return (sum_load > 0.0) ? max_load*Real(nprocs)/sum_load : 1.0;
+}
+
 std::vector<std::vector<int> >
 DistributionMapping::makeSFC (const BoxArray& ba, bool use_box_vol)
 {
@@ -31,6 +31,7 @@ EArena::alloc (std::size_t nbytes)
 {
     std::lock_guard<std::mutex> lock(earena_mutex);
 
+    ++m_num_allocs;
     nbytes = Arena::align(nbytes == 0 ? 1 : nbytes);
 
     auto fit = m_freelist.lower_bound(Node{nbytes});
@@ -1,5 +1,6 @@
 
 #include <algorithm>
+#include <limits>
 #include <AMReX_FabArrayBase.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Utility.H>
@@ -24,6 +25,12 @@ namespace amrex {
 // Set default values in Initialize()!!!
 //
 int     FabArrayBase::MaxComp;
+bool    FabArrayBase::use_persistent_fb_plan;
+int     FabArrayBase::max_fb_plans;
+FabArrayBase::CommBackend FabArrayBase::comm_backend;
+Vector<IntVect> FabArrayBase::tile_tune_candidates;
+int             FabArrayBase::tile_tune_trials;
+std::string     FabArrayBase::tile_tune_file;
 
 #if defined(AMREX_USE_GPU) && defined(AMREX_USE_GPU_PRAGMA)
 
@@ -56,6 +63,7 @@ IntVect FabArrayBase::mfghostiter_tile_size(AMREX_D_DECL(1024000, 8, 8));
 #endif
 
 FabArrayBase::TACache              FabArrayBase::m_TheTileArrayCache;
+FabArrayBase::TTCache              FabArrayBase::m_TheTunedTileSizeCache;
 FabArrayBase::FBCache              FabArrayBase::m_TheFBCache;
 FabArrayBase::CPCache              FabArrayBase::m_TheCPCache;
 FabArrayBase::FPinfoCache          FabArrayBase::m_TheFillPatchCache;
@@ -66,6 +74,7 @@ FabArrayBase::CacheStats           FabArrayBase::m_FBC_stats("FBCache");
 FabArrayBase::CacheStats           FabArrayBase::m_CPC_stats("CopyCache");
 FabArrayBase::CacheStats           FabArrayBase::m_FPinfo_stats("FillPatchCache");
 FabArrayBase::CacheStats           FabArrayBase::m_CFinfo_stats("CrseFineCache");
+FabArrayBase::CacheStats           FabArrayBase::m_FBPlan_stats("FBPlans");
 
 std::map<FabArrayBase::BDKey, int> FabArrayBase::m_BD_count;
 
@@ -78,6 +87,7 @@ namespace
 {
     Arena* the_fa_arena = nullptr;
     bool initialized = false;
+    long fb_id_counter = 0;
 }
 
 void
@@ -90,6 +100,12 @@ FabArrayBase::Initialize ()
     // Set default values here!!!
     //
     FabArrayBase::MaxComp           = 25;
+    FabArrayBase::use_persistent_fb_plan = false;
+    FabArrayBase::max_fb_plans      = 8;
+    FabArrayBase::comm_backend      = FabArrayBase::P2P;
+    FabArrayBase::tile_tune_trials  = 2;
+    FabArrayBase::tile_tune_file.clear();
+    FabArrayBase::tile_tune_candidates.clear();
 
     ParmParse pp("fabarray");
 
@@ -110,12 +126,79 @@ FabArrayBase::Initialize ()
         for (int i=0; i<AMREX_SPACEDIM; i++) FabArrayBase::comm_tile_size[i] = tilesize[i];
     }
 
+    {
+        Vector<int> cands;
+        if (pp.queryarr("tile_tune_candidates", cands) && cands.size() >= AMREX_SPACEDIM)
+        {
+            for (int i = 0; i+AMREX_SPACEDIM <= cands.size(); i += AMREX_SPACEDIM) {
+                tile_tune_candidates.push_back(IntVect(&cands[i]));
+            }
+        }
+        else
+        {
+            const int L = 1024000;
+            tile_tune_candidates.push_back(FabArrayBase::mfiter_tile_size);
+#if (AMREX_SPACEDIM == 1)
+            for (int t : {L, 1024, 256, 64}) {
+                tile_tune_candidates.push_back(IntVect(t));
+            }
+#elif (AMREX_SPACEDIM == 2)
+            for (int t : {4, 8, 16, 32, 64}) {
+                tile_tune_candidates.push_back(IntVect(L,t));
+            }
+#else
+            for (int t : {4, 8, 16, 32}) {
+                tile_tune_candidates.push_back(IntVect(L,t,t));
+            }
+            tile_tune_candidates.push_back(IntVect(64,16,16));
+            tile_tune_candidates.push_back(IntVect(32,8,8));
+#endif
+            // remove the duplicate of mfiter_tile_size
+            for (int i = 1, N = tile_tune_candidates.size(); i < N; ++i) {
+                if (tile_tune_candidates[i] == FabArrayBase::mfiter_tile_size) {
+                    tile_tune_candidates.erase(tile_tune_candidates.begin()+i);
+                    break;
+                }
+            }
+        }
+    }
+
+    pp.query("tile_tune_trials",    FabArrayBase::tile_tune_trials);
+    FabArrayBase::tile_tune_trials = std::max(FabArrayBase::tile_tune_trials, 1);
+    pp.query("tile_tune_file",      FabArrayBase::tile_tune_file);
+
     pp.query("maxcomp",             FabArrayBase::MaxComp);
 
     if (MaxComp < 1) {
         MaxComp = 1;
     }
 
+    pp.query("persistent_fb_plan",  FabArrayBase::use_persistent_fb_plan);
+    pp.query("max_fb_plans",        FabArrayBase::max_fb_plans);
+
+    if (max_fb_plans < 1) {
+        max_fb_plans = 1;
+    }
+
+    {
+        ParmParse ppa("amrex");
+        std::string backend;
+        if (ppa.query("comm_backend", backend))
+        {
+            if (backend == "p2p") {
+                comm_backend = P2P;
+            } else if (backend == "neighbor") {
+#if defined(BL_USE_MPI) && (MPI_VERSION >= 3)
+                comm_backend = NEIGHBOR;
+#else
+                amrex::Abort("amrex.comm_backend = neighbor requires MPI-3");
+#endif
+            } else {
+                amrex::Abort("amrex.comm_backend must be p2p or neighbor");
+            }
+        }
+    }
+
     if (ParallelDescriptor::UseGpuAwareMpi()) {
         the_fa_arena = The_Device_Arena();
     } else {
@@ -208,6 +291,117 @@ FabArrayBase::fabbox (int K) const noexcept
     return amrex::grow(boxarray[K], n_grow);
 }
 
+FabArrayBase::CommMetaData::~CommMetaData ()
+{
+#ifdef BL_USE_MPI
+    if (m_nbr_comm != MPI_COMM_NULL) {
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        if (!finalized) MPI_Comm_free(&m_nbr_comm);
+    }
+#endif
+}
+
+MPI_Comm
+FabArrayBase::CommMetaData::getNeighborComm () const
+{
+#if defined(BL_USE_MPI) && (MPI_VERSION >= 3)
+    MPI_Comm comm = ParallelContext::CommunicatorSub();
+    if (m_nbr_comm != MPI_COMM_NULL && m_nbr_parent == comm) {
+        return m_nbr_comm;
+    }
+
+    BL_PROFILE("CommMetaData::getNeighborComm()");
+
+    if (m_nbr_comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&m_nbr_comm);
+    }
+
+    Vector<int> srcs, dsts;
+    for (auto const& kv : *m_RcvTags) {
+        srcs.push_back(ParallelContext::global_to_local_rank(kv.first));
+    }
+    for (auto const& kv : *m_SndTags) {
+        dsts.push_back(ParallelContext::global_to_local_rank(kv.first));
+    }
+
+    BL_MPI_REQUIRE( MPI_Dist_graph_create_adjacent(comm,
+                                                   srcs.size(), srcs.data(), MPI_UNWEIGHTED,
+                                                   dsts.size(), dsts.data(), MPI_UNWEIGHTED,
+                                                   MPI_INFO_NULL, 0, &m_nbr_comm) );
+    m_nbr_parent = comm;
+    return m_nbr_comm;
+#else
+    amrex::Abort("CommMetaData::getNeighborComm: MPI-3 is required");
+    return MPI_COMM_NULL;
+#endif
+}
+
+void
+FabArrayBase::NbrExchangeStart (const CommMetaData& cmd,
+                                char* the_send_data,
+                                Vector<std::size_t> const& send_offset,
+                                Vector<std::size_t> const& send_size,
+                                char* the_recv_data,
+                                Vector<std::size_t> const& recv_offset,
+                                Vector<std::size_t> const& recv_size,
+                                NbrExchange& nx)
+{
+#if defined(BL_USE_MPI) && (MPI_VERSION >= 3)
+    BL_PROFILE("FabArrayBase::NbrExchangeStart()");
+
+    auto to_int = [] (std::size_t n) -> int
+    {
+        if (n > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+            amrex::Abort("NbrExchangeStart: message size is too big");
+        }
+        return static_cast<int>(n);
+    };
+
+    const int nsend = send_size.size();
+    nx.send_counts.resize(nsend);
+    nx.send_displs.resize(nsend);
+    for (int i = 0; i < nsend; ++i) {
+        nx.send_counts[i] = to_int(send_size[i]);
+        nx.send_displs[i] = to_int(send_offset[i]);
+    }
+
+    const int nrecv = recv_size.size();
+    nx.recv_counts.resize(nrecv);
+    nx.recv_displs.resize(nrecv);
+    for (int i = 0; i < nrecv; ++i) {
+        nx.recv_counts[i] = to_int(recv_size[i]);
+        nx.recv_displs[i] = to_int(recv_offset[i]);
+    }
+
+    MPI_Comm comm = cmd.getNeighborComm();
+
+    BL_MPI_REQUIRE( MPI_Ineighbor_alltoallv(the_send_data, nx.send_counts.data(),
+                                            nx.send_displs.data(), MPI_CHAR,
+                                            the_recv_data, nx.recv_counts.data(),
+                                            nx.recv_displs.data(), MPI_CHAR,
+                                            comm, &nx.req) );
+    nx.active = true;
+#else
+    amrex::ignore_unused(cmd,the_send_data,send_offset,send_size,
+                         the_recv_data,recv_offset,recv_size,nx);
+    amrex::Abort("FabArrayBase::NbrExchangeStart: MPI-3 is required");
+#endif
+}
+
+void
+FabArrayBase::NbrExchangeFinish (NbrExchange& nx)
+{
+#ifdef BL_USE_MPI
+    if (nx.active) {
+        BL_PROFILE("FabArrayBase::NbrExchangeFinish()");
+        MPI_Status status;
+        BL_MPI_REQUIRE( MPI_Wait(&nx.req, &status) );
+        nx.active = false;
+    }
+#endif
+}
+
 long
 FabArrayBase::bytesOfMapOfCopyComTagContainers (const FabArrayBase::MapOfCopyComTagContainers& m)
 {
@@ -603,7 +797,8 @@ FabArrayBase::getCPC (const IntVect& dstng, const FabArrayBase& src, const IntVe
 FabArrayBase::FB::FB (const FabArrayBase& fa, const IntVect& nghost,
                       bool cross, const Periodicity& period, 
                       bool enforce_periodicity_only)
-    : m_typ(fa.boxArray().ixType()), m_crse_ratio(fa.boxArray().crseRatio()),
+    : m_id(fb_id_counter++),
+      m_typ(fa.boxArray().ixType()), m_crse_ratio(fa.boxArray().crseRatio()),
       m_ngrow(nghost), m_cross(cross),
       m_epo(enforce_periodicity_only), m_period(period),
       m_nuse(0)
@@ -1012,6 +1207,120 @@ FabArrayBase::flushFBCache ()
 #endif
 }
 
+FabArrayBase::FBPlan::~FBPlan ()
+{
+#ifdef BL_USE_MPI
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+        for (auto& req : m_send_reqs) {
+            if (req != MPI_REQUEST_NULL) MPI_Request_free(&req);
+        }
+        for (auto& req : m_recv_reqs) {
+            if (req != MPI_REQUEST_NULL) MPI_Request_free(&req);
+        }
+    }
+#endif
+    // The arena is gone if the plan outlives amrex::Finalize().
+    if (the_fa_arena) {
+        if (m_the_send_data) the_fa_arena->free(m_the_send_data);
+        if (m_the_recv_data) the_fa_arena->free(m_the_recv_data);
+    }
+    if (m_nuse > 0) {
+        m_FBPlan_stats.recordErase(m_nuse);
+#ifdef AMREX_MEM_PROFILING
+        m_FBPlan_stats.bytes -= bytes();
+#endif
+    }
+}
+
+void
+FabArrayBase::FBPlan::initRequests ()
+{
+#ifdef BL_USE_MPI
+    auto init = [this] (char* buf, std::size_t nbytes, int rank, bool is_send,
+                        MPI_Request* req)
+    {
+        MPI_Datatype dtype = MPI_DATATYPE_NULL;
+        std::size_t count = 0;
+        const int comm_data_type = select_comm_data_type(nbytes);
+        if (comm_data_type == 1) {
+            dtype = ParallelDescriptor::Mpi_typemap<char>::type();
+            count = nbytes;
+        } else if (comm_data_type == 2) {
+            dtype = ParallelDescriptor::Mpi_typemap<unsigned long long>::type();
+            count = nbytes/sizeof(unsigned long long);
+        } else if (comm_data_type == 3) {
+            dtype = ParallelDescriptor::Mpi_typemap<ParallelDescriptor::lull_t>::type();
+            count = nbytes/sizeof(ParallelDescriptor::lull_t);
+        } else {
+            amrex::Abort("TODO: message size is too big");
+        }
+        if (is_send) {
+            BL_MPI_REQUIRE( MPI_Send_init(buf, count, dtype, rank, m_tag, m_comm, req) );
+        } else {
+            BL_MPI_REQUIRE( MPI_Recv_init(buf, count, dtype, rank, m_tag, m_comm, req) );
+        }
+    };
+
+    const int nsend = m_send_data.size();
+    m_send_reqs.assign(nsend, MPI_REQUEST_NULL);
+    m_send_stat.resize(nsend);
+    for (int i = 0; i < nsend; ++i) {
+        init(m_send_data[i], m_send_size[i], m_send_rank[i], true, &m_send_reqs[i]);
+    }
+
+    const int nrecv = m_recv_data.size();
+    m_recv_reqs.assign(nrecv, MPI_REQUEST_NULL);
+    m_recv_stat.resize(nrecv);
+    for (int i = 0; i < nrecv; ++i) {
+        init(m_recv_data[i], m_recv_size[i], m_recv_rank[i], false, &m_recv_reqs[i]);
+    }
+#endif
+}
+
+void
+FabArrayBase::FBPlan::startRecvs ()
+{
+#ifdef BL_USE_MPI
+    if (!m_recv_reqs.empty()) {
+        BL_MPI_REQUIRE( MPI_Startall(m_recv_reqs.size(), m_recv_reqs.data()) );
+    }
+#endif
+}
+
+void
+FabArrayBase::FBPlan::startSends ()
+{
+#ifdef BL_USE_MPI
+    if (!m_send_reqs.empty()) {
+        BL_MPI_REQUIRE( MPI_Startall(m_send_reqs.size(), m_send_reqs.data()) );
+    }
+#endif
+}
+
+void
+FabArrayBase::FBPlan::waitRecvs ()
+{
+#ifdef BL_USE_MPI
+    if (!m_recv_reqs.empty()) {
+        BL_MPI_REQUIRE( MPI_Waitall(m_recv_reqs.size(), m_recv_reqs.data(),
+                                    m_recv_stat.data()) );
+    }
+#endif
+}
+
+void
+FabArrayBase::FBPlan::waitSends ()
+{
+#ifdef BL_USE_MPI
+    if (!m_send_reqs.empty()) {
+        BL_MPI_REQUIRE( MPI_Waitall(m_send_reqs.size(), m_send_reqs.data(),
+                                    m_send_stat.data()) );
+    }
+#endif
+}
+
 const FabArrayBase::FB&
 FabArrayBase::getFB (const IntVect& nghost, const Periodicity& period,
                      bool cross, bool enforce_periodicity_only) const
@@ -1380,6 +1689,7 @@ FabArrayBase::Finalize ()
 	m_CPC_stats.print();
 	m_FPinfo_stats.print();
 	m_CFinfo_stats.print();
+	m_FBPlan_stats.print();
     }
 
     if (amrex::system::verbose > 1) {
@@ -1392,6 +1702,7 @@ FabArrayBase::Finalize ()
     m_CPC_stats = CacheStats("CopyCache");
     m_FPinfo_stats = CacheStats("FillPatchCache");
     m_CFinfo_stats = CacheStats("CrseFineCache");
+    m_FBPlan_stats = CacheStats("FBPlans");
 
     m_BD_count.clear();
     
@@ -1550,6 +1861,7 @@ FabArrayBase::flushTileArray (const IntVect& tileSize, bool no_assertion) const
 		m_TAC_stats.recordErase(tai_it->second.nuse);
 	    }
 	    tao.erase(tao_it);
+	    m_TheTunedTileSizeCache.erase(m_bdkey);
 	} 
 	else 
 	{
@@ -1580,6 +1892,7 @@ FabArrayBase::flushTileArrayCache ()
 	}
     }
     m_TheTileArrayCache.clear();
+    m_TheTunedTileSizeCache.clear();
 #ifdef AMREX_MEM_PROFILING
     m_TAC_stats.bytes = 0L;
 #endif
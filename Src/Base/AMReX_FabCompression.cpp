@@ -0,0 +1,376 @@
+#include <AMReX_FabCompression.H>
+#include <AMReX.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace amrex {
+namespace FabCompression {
+
+namespace {
+
+    const int  lz_hash_log   = 16;
+    const long lz_min_match  = 4;
+    const long lz_max_offset = 65535;
+
+    // The lengths and counts in the compressed streams are little endian,
+    // so that the streams do not depend on the machine.
+    void putU64 (Vector<char>& dst, std::uint64_t v)
+    {
+        for (int i = 0; i < 8; ++i) {
+            dst.push_back(static_cast<char>((v >> (8*i)) & 0xff));
+        }
+    }
+
+    std::uint64_t getU64 (const unsigned char* p)
+    {
+        std::uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) {
+            v |= static_cast<std::uint64_t>(p[i]) << (8*i);
+        }
+        return v;
+    }
+
+    void putLength (Vector<char>& dst, long v)
+    {
+        while (v >= 255) {
+            dst.push_back(static_cast<char>(255));
+            v -= 255;
+        }
+        dst.push_back(static_cast<char>(v));
+    }
+
+    void corrupt ()
+    {
+        amrex::Abort("FabCompression: corrupt compressed data");
+    }
+
+    // A sequence is a token, the literals, and, unless it is the last one,
+    // a match of at least lz_min_match bytes at a distance of up to
+    // lz_max_offset.  The upper four bits of the token are the number of
+    // literals and the lower four the match length minus lz_min_match, with
+    // 15 meaning that more of the length follows in bytes of up to 255.
+    void emitSequence (Vector<char>& dst, const unsigned char* lit, long nlit,
+                       long offset, long len)
+    {
+        const long mcode = (len > 0) ? len - lz_min_match : 0;
+        const int token = (static_cast<int>(std::min(nlit, 15L)) << 4)
+                        |  static_cast<int>(std::min(mcode, 15L));
+        dst.push_back(static_cast<char>(token));
+        if (nlit >= 15) putLength(dst, nlit - 15);
+        dst.insert(dst.end(), lit, lit + nlit);
+        if (len > 0) {
+            dst.push_back(static_cast<char>(offset & 0xff));
+            dst.push_back(static_cast<char>((offset >> 8) & 0xff));
+            if (mcode >= 15) putLength(dst, mcode - 15);
+        }
+    }
+
+    // The first byte of a compressed FAB says how it was compressed.
+    enum : char { mode_stored = 0, mode_shuffle_lz = 1, mode_quantized = 2 };
+
+    void compressLossless (const Real* src, long n, Vector<char>& dst)
+    {
+        const long nbytes = n * static_cast<long>(sizeof(Real));
+        const int  s = sizeof(Real);
+        const char* in = reinterpret_cast<const char*>(src);
+
+        Vector<char> shuffled(nbytes);
+        for (long i = 0; i < n; ++i) {
+            for (int b = 0; b < s; ++b) {
+                shuffled[b*n+i] = in[i*s+b];
+            }
+        }
+
+        Vector<char> lz;
+        LZCompress(shuffled.data(), nbytes, lz);
+
+        dst.clear();
+        if (static_cast<long>(lz.size()) < nbytes) {
+            dst.reserve(lz.size() + 1);
+            dst.push_back(mode_shuffle_lz);
+            dst.insert(dst.end(), lz.begin(), lz.end());
+        } else {
+            dst.reserve(nbytes + 1);
+            dst.push_back(mode_stored);
+            dst.insert(dst.end(), in, in + nbytes);
+        }
+    }
+
+    void decompressLossless (const char* src, long nbytes, Real* dst, long n)
+    {
+        const long rbytes = n * static_cast<long>(sizeof(Real));
+        const int  s = sizeof(Real);
+
+        if (nbytes < 1) corrupt();
+        if (src[0] == mode_stored) {
+            if (nbytes - 1 != rbytes) corrupt();
+            std::memcpy(dst, src + 1, rbytes);
+        } else if (src[0] == mode_shuffle_lz) {
+            Vector<char> shuffled;
+            LZDecompress(src + 1, nbytes - 1, shuffled);
+            if (static_cast<long>(shuffled.size()) != rbytes) corrupt();
+            char* out = reinterpret_cast<char*>(dst);
+            for (long i = 0; i < n; ++i) {
+                for (int b = 0; b < s; ++b) {
+                    out[i*s+b] = shuffled[b*n+i];
+                }
+            }
+        } else {
+            corrupt();
+        }
+    }
+
+    class ShuffleLZCodec
+        : public FabCodec
+    {
+    public:
+        virtual std::string spec () const override { return "shuffle_lz"; }
+
+        virtual void compress (const Real* src, long n, Vector<char>& dst) const override
+        {
+            compressLossless(src, n, dst);
+        }
+
+        virtual void decompress (const char* src, long nbytes, Real* dst, long n) const override
+        {
+            decompressLossless(src, nbytes, dst, n);
+        }
+    };
+
+    class QuantizeCodec
+        : public FabCodec
+    {
+    public:
+        QuantizeCodec (const std::string& args)
+            : m_args(args)
+        {
+            try {
+                m_eps = std::stod(args);
+            } catch (...) {
+                m_eps = -1.0;
+            }
+            if (!(m_eps > 0.0)) {
+                amrex::Abort("FabCompression: quantize needs a positive error bound, e.g., quantize:1.e-6");
+            }
+            m_step = 2.0 * m_eps;
+        }
+
+        virtual std::string spec () const override { return "quantize:" + m_args; }
+
+        virtual void compress (const Real* src, long n, Vector<char>& dst) const override
+        {
+            // Quantize, take the differences of neighbors, zigzag them so
+            // that small negative and positive differences are small
+            // unsigned numbers, and write those in 7-bit groups.
+            Vector<char> varints;
+            varints.reserve(2*n);
+            std::int64_t prev = 0;
+            for (long i = 0; i < n; ++i)
+            {
+                const double qd = std::nearbyint(static_cast<double>(src[i]) / m_step);
+                // Also false for NaN.
+                if (!(std::abs(qd) < 4.e18)) {
+                    compressLossless(src, n, dst);
+                    return;
+                }
+                const std::int64_t q = static_cast<std::int64_t>(qd);
+                const Real r = static_cast<Real>(static_cast<double>(q) * m_step);
+                if (!(std::abs(static_cast<double>(r) - static_cast<double>(src[i])) <= m_eps)) {
+                    compressLossless(src, n, dst);
+                    return;
+                }
+                const std::int64_t d = q - prev;
+                prev = q;
+                std::uint64_t z = (static_cast<std::uint64_t>(d) << 1)
+                                ^  static_cast<std::uint64_t>(d >> 63);
+                while (z >= 0x80) {
+                    varints.push_back(static_cast<char>((z & 0x7f) | 0x80));
+                    z >>= 7;
+                }
+                varints.push_back(static_cast<char>(z));
+            }
+
+            Vector<char> lz;
+            LZCompress(varints.data(), varints.size(), lz);
+
+            dst.clear();
+            dst.reserve(lz.size() + 1);
+            dst.push_back(mode_quantized);
+            dst.insert(dst.end(), lz.begin(), lz.end());
+        }
+
+        virtual void decompress (const char* src, long nbytes, Real* dst, long n) const override
+        {
+            if (nbytes < 1) corrupt();
+            if (src[0] != mode_quantized) {
+                decompressLossless(src, nbytes, dst, n);
+                return;
+            }
+
+            Vector<char> varints;
+            LZDecompress(src + 1, nbytes - 1, varints);
+
+            const unsigned char* p   = reinterpret_cast<const unsigned char*>(varints.data());
+            const unsigned char* end = p + varints.size();
+            std::int64_t q = 0;
+            for (long i = 0; i < n; ++i)
+            {
+                std::uint64_t z = 0;
+                int shift = 0;
+                while (true) {
+                    if (p == end || shift > 63) corrupt();
+                    const unsigned char b = *p++;
+                    z |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+                    if (b < 0x80) break;
+                    shift += 7;
+                }
+                const std::int64_t d = static_cast<std::int64_t>(z >> 1) ^ -static_cast<std::int64_t>(z & 1);
+                q += d;
+                dst[i] = static_cast<Real>(static_cast<double>(q) * m_step);
+            }
+            if (p != end) corrupt();
+        }
+
+    private:
+        std::string m_args;
+        double m_eps;
+        double m_step;
+    };
+
+    std::map<std::string,Factory>& registry ()
+    {
+        static std::map<std::string,Factory> r {
+            { "shuffle_lz", [] (const std::string&) -> std::unique_ptr<FabCodec>
+                            { return std::unique_ptr<FabCodec>(new ShuffleLZCodec()); } },
+            { "quantize",   [] (const std::string& args) -> std::unique_ptr<FabCodec>
+                            { return std::unique_ptr<FabCodec>(new QuantizeCodec(args)); } }
+        };
+        return r;
+    }
+}
+
+void
+Register (const std::string& name, Factory factory)
+{
+    registry()[name] = std::move(factory);
+}
+
+std::unique_ptr<FabCodec>
+Create (const std::string& spec)
+{
+    const auto colon = spec.find(':');
+    const std::string name = spec.substr(0, colon);
+    const std::string args = (colon == std::string::npos) ? std::string() : spec.substr(colon+1);
+
+    auto it = registry().find(name);
+    if (it == registry().end()) {
+        amrex::Abort("FabCompression::Create: unknown codec " + spec);
+    }
+    return it->second(args);
+}
+
+void
+LZCompress (const char* src, long nbytes, Vector<char>& dst)
+{
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(src);
+
+    dst.clear();
+    dst.reserve(nbytes + nbytes/255 + 16);
+    putU64(dst, nbytes);
+
+    std::vector<long> table(1 << lz_hash_log, -1);
+    long anchor = 0;
+    long i = 0;
+    while (i + lz_min_match <= nbytes)
+    {
+        std::uint32_t seq;
+        std::memcpy(&seq, in + i, 4);
+        const std::uint32_t h = (seq * 2654435761u) >> (32 - lz_hash_log);
+        const long cand = table[h];
+        table[h] = i;
+
+        if (cand >= 0 && i - cand <= lz_max_offset && std::memcmp(in + cand, in + i, 4) == 0)
+        {
+            long len = lz_min_match;
+            while (i + len < nbytes && in[cand+len] == in[i+len]) {
+                ++len;
+            }
+            emitSequence(dst, in + anchor, i - anchor, i - cand, len);
+            i += len;
+            anchor = i;
+        }
+        else
+        {
+            // Skip faster through data that do not compress.
+            i += 1 + ((i - anchor) >> 6);
+        }
+    }
+    emitSequence(dst, in + anchor, nbytes - anchor, 0, 0);
+}
+
+void
+LZDecompress (const char* src, long nbytes, Vector<char>& dst)
+{
+    const unsigned char* ip   = reinterpret_cast<const unsigned char*>(src);
+    const unsigned char* iend = ip + nbytes;
+
+    if (nbytes < 8) corrupt();
+    const long n = static_cast<long>(getU64(ip));
+    ip += 8;
+    dst.resize(n);
+    char* out = dst.data();
+    long op = 0;
+
+    while (ip < iend)
+    {
+        const int token = *ip++;
+
+        long nlit = token >> 4;
+        if (nlit == 15) {
+            unsigned char b;
+            do {
+                if (ip == iend) corrupt();
+                b = *ip++;
+                nlit += b;
+            } while (b == 255);
+        }
+        if (nlit > iend - ip || nlit > n - op) corrupt();
+        std::memcpy(out + op, ip, nlit);
+        ip += nlit;
+        op += nlit;
+
+        if (ip == iend) break;
+
+        if (iend - ip < 2) corrupt();
+        const long offset = ip[0] | (static_cast<long>(ip[1]) << 8);
+        ip += 2;
+        long len = token & 15;
+        if (len == 15) {
+            unsigned char b;
+            do {
+                if (ip == iend) corrupt();
+                b = *ip++;
+                len += b;
+            } while (b == 255);
+        }
+        len += lz_min_match;
+        if (offset == 0 || offset > op || len > n - op) corrupt();
+
+        // The match may overlap the bytes it produces.
+        const char* m = out + op - offset;
+        for (long k = 0; k < len; ++k) {
+            out[op+k] = m[k];
+        }
+        op += len;
+    }
+
+    if (op != n) corrupt();
+}
+
+}
+}
@@ -2,11 +2,117 @@
 #include <AMReX_MFIter.H>
 #include <AMReX_FabArray.H>
 #include <AMReX_FArrayBox.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Print.H>
+#include <AMReX_LayoutData.H>
+#include <AMReX_TinyProfiler.H>
+
+#include <atomic>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <mutex>
+#include <set>
 
 namespace amrex {
 
 int MFIter::nextDynamicIndex = std::numeric_limits<int>::min();
 
+IntVect                 MFIter::tunedTileSize;
+MFIter::TileTuneRecord* MFIter::tunedRecord = nullptr;
+
+MFIter::WorkStealingStats MFIter::wsStats;
+
+//! Timings of the candidate tile sizes for a region and a box size
+struct MFIter::TileTuneRecord
+{
+    Vector<IntVect> candidates;
+    Vector<double>  time;
+    Vector<int>     trials;
+    int     current = -1;
+    double  pending = 0.0;
+    bool    done = false;
+    IntVect best;
+};
+
+namespace {
+
+    std::map<std::string,MFIter::TileTuneRecord> tile_tune_records;
+    bool tile_tune_initialized = false;
+
+    // The region name followed by every distinct box size of the
+    // BoxArray, e.g. "advection:32:32:32,16:32:32".  BoxArrays that only
+    // share the size of their first box are tuned separately.
+    std::string tile_tune_key (const std::string& region, const BoxArray& ba)
+    {
+        std::set<Array<int,AMREX_SPACEDIM> > sizes;
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            const IntVect& len = ba[i].length();
+            sizes.insert({AMREX_D_DECL(len[0],len[1],len[2])});
+        }
+
+        std::ostringstream os;
+        for (char c : region) {
+            os << (std::isspace(static_cast<unsigned char>(c)) ? '_' : c);
+        }
+        char sep = ':';
+        for (const auto& len : sizes) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                os << (idim == 0 ? sep : ':') << len[idim];
+            }
+            sep = ',';
+        }
+        return os.str();
+    }
+
+    // Each line of the file is a key followed by the tile size.
+    void tile_tune_read_file ()
+    {
+        if (FabArrayBase::tile_tune_file.empty()) return;
+        std::ifstream ifs(FabArrayBase::tile_tune_file);
+        std::string key;
+        IntVect ts;
+        while (ifs >> key) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                ifs >> ts[idim];
+            }
+            if (!ifs) break;
+            MFIter::TileTuneRecord& rec = tile_tune_records[key];
+            rec.done = true;
+            rec.best = ts;
+        }
+    }
+
+    // Work stealing queue of a thread.  The range [head,tail) of tile
+    // indices is owned by the thread.  The owner takes tiles from the head
+    // and thieves take them from the tail.
+    struct WSQueue
+    {
+        std::mutex mutex;
+        std::atomic<int> head{0};
+        std::atomic<int> tail{0};
+        double finish = 0.0;
+        long nsteals = 0;
+        char pad[64];
+    };
+
+    std::unique_ptr<WSQueue[]> ws_queues;
+    int ws_nqueues = 0;
+    std::atomic<int> ws_nfinished{0};
+
+    void tile_tune_write_file (const std::string& key, const IntVect& ts)
+    {
+        if (FabArrayBase::tile_tune_file.empty() || !ParallelDescriptor::IOProcessor()) return;
+        std::ofstream ofs(FabArrayBase::tile_tune_file, std::ios::app);
+        ofs << key;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            ofs << ' ' << ts[idim];
+        }
+        ofs << '\n';
+    }
+}
+
 MFIter::MFIter (const FabArrayBase& fabarray_, 
 		unsigned char       flags_)
     :
@@ -140,12 +246,17 @@ MFIter::MFIter (const BoxArray& ba, const DistributionMapping& dm, const MFItInf
     dynamic(false),
 #endif
     device_sync(info.device_sync),
+#ifdef _OPENMP
+    work_stealing(info.work_stealing && (omp_get_num_threads() > 1)),
+#endif
     index_map(nullptr),
     local_index_map(nullptr),
     tile_array(nullptr),
     local_tile_index_map(nullptr),
     num_local_tiles(nullptr)
 {
+    if (work_stealing) dynamic = false;
+
 #ifdef _OPENMP
     if (dynamic) {
 #pragma omp barrier
@@ -155,7 +266,15 @@ MFIter::MFIter (const BoxArray& ba, const DistributionMapping& dm, const MFItInf
     }
 #endif
 
+    if (info.do_tiling && !info.tune_region.empty()) {
+        TuneTileSize(info.tune_region);
+    }
+
     Initialize();
+
+    if (work_stealing) {
+        WSInitialize(info.cost);
+    }
 }
 
 MFIter::MFIter (const FabArrayBase& fabarray_, const MFItInfo& info)
@@ -170,12 +289,17 @@ MFIter::MFIter (const FabArrayBase& fabarray_, const MFItInfo& info)
     dynamic(false),
 #endif
     device_sync(info.device_sync),
+#ifdef _OPENMP
+    work_stealing(info.work_stealing && (omp_get_num_threads() > 1)),
+#endif
     index_map(nullptr),
     local_index_map(nullptr),
     tile_array(nullptr),
     local_tile_index_map(nullptr),
     num_local_tiles(nullptr)
 {
+    if (work_stealing) dynamic = false;
+
 #ifdef _OPENMP
     if (dynamic) {
 #pragma omp barrier
@@ -185,12 +309,32 @@ MFIter::MFIter (const FabArrayBase& fabarray_, const MFItInfo& info)
     }
 #endif
 
+    if (info.do_tiling && !info.tune_region.empty()) {
+        TuneTileSize(info.tune_region);
+    }
+
     Initialize();
+
+    if (work_stealing) {
+        WSInitialize(info.cost);
+    }
 }
 
 
 MFIter::~MFIter ()
 {
+    if (work_stealing) {
+        WSFinalize();
+    }
+
+    if (m_tune) {
+        const double t = amrex::second() - m_tune_start;
+#ifdef _OPENMP
+#pragma omp critical(mfiter_tile_tune)
+#endif
+        m_tune->pending = std::max(m_tune->pending, t);
+    }
+
 #ifdef BL_USE_TEAM
     if ( ! (flags & NoTeamBarrier) )
 	ParallelDescriptor::MyTeam().MemoryBarrier();
@@ -219,6 +363,235 @@ MFIter::~MFIter ()
 #endif
 }
 
+void
+MFIter::TuneTileSize (const std::string& region)
+{
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion()) return;
+#endif
+
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp single
+#endif
+    {
+        tunedTileSize = tile_size;
+        tunedRecord = nullptr;
+
+        FabArrayBase::TTMap& ttmap = FabArrayBase::m_TheTunedTileSizeCache[fabArray.getBDKey()];
+        auto found = ttmap.find(region);
+        if (found != ttmap.end())
+        {
+            tunedTileSize = found->second;
+        }
+        else if (!fabArray.IndexArray().empty())
+        {
+            if (!tile_tune_initialized) {
+                tile_tune_initialized = true;
+                tile_tune_read_file();
+                amrex::ExecOnFinalize([] () {
+                    tile_tune_records.clear();
+                    tile_tune_initialized = false;
+                });
+            }
+
+            const std::string key = tile_tune_key(region, fabArray.boxArray());
+            TileTuneRecord& rec = tile_tune_records[key];
+
+            if (!rec.done)
+            {
+                if (rec.candidates.empty()) {
+                    rec.candidates = FabArrayBase::tile_tune_candidates;
+                    if (rec.candidates.empty()) {
+                        rec.candidates.push_back(tile_size);
+                    }
+                    rec.time.assign(rec.candidates.size(), 0.0);
+                    rec.trials.assign(rec.candidates.size(), 0);
+                }
+
+                // Timing of the previous loop of this record
+                if (rec.current >= 0 && rec.pending > 0.0) {
+                    rec.time[rec.current] += rec.pending;
+                    ++rec.trials[rec.current];
+                }
+                rec.pending = 0.0;
+
+                rec.current = -1;
+                for (int i = 0, N = rec.candidates.size(); i < N; ++i) {
+                    if (rec.trials[i] < FabArrayBase::tile_tune_trials) {
+                        rec.current = i;
+                        break;
+                    }
+                }
+
+                if (rec.current < 0)
+                {
+                    int ibest = 0;
+                    for (int i = 1, N = rec.candidates.size(); i < N; ++i) {
+                        if (rec.time[i]/rec.trials[i] < rec.time[ibest]/rec.trials[ibest]) {
+                            ibest = i;
+                        }
+                    }
+                    rec.done = true;
+                    rec.best = rec.candidates[ibest];
+                    tile_tune_write_file(key, rec.best);
+                    if (amrex::Verbose() > 1) {
+                        amrex::Print() << "MFIter tile size tuning: " << key
+                                       << " -> " << rec.best << "\n";
+                    }
+                }
+            }
+
+            if (rec.done) {
+                ttmap[region] = rec.best;
+                tunedTileSize = rec.best;
+            } else {
+                tunedTileSize = rec.candidates[rec.current];
+                tunedRecord = &rec;
+            }
+        }
+    }
+
+    tile_size = tunedTileSize;
+    m_tune = tunedRecord;
+    m_tune_start = amrex::second();
+}
+
+void
+MFIter::WSInitialize (const LayoutData<Real>* cost)
+{
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp single
+    {
+        const int nthreads = omp_get_num_threads();
+        if (ws_nqueues != nthreads) {
+            ws_queues.reset(new WSQueue[nthreads]);
+            ws_nqueues = nthreads;
+        }
+
+        const int ntiles = endIndex - beginIndex;
+        Vector<double> w(ntiles);
+        double wtot = 0.0;
+        for (int i = 0; i < ntiles; ++i) {
+            const int t = beginIndex + i;
+            const Box& tbx = (*tile_array)[t];
+            if (cost) {
+                const Box& vbx = fabArray.box((*index_map)[t]);
+                w[i] = (*cost)[(*index_map)[t]] * (double(tbx.numPts()) / double(vbx.numPts()));
+            } else {
+                w[i] = static_cast<double>(tbx.numPts());
+            }
+            wtot += w[i];
+        }
+
+        // Contiguous ranges of about the same cost
+        int it = 0;
+        double wsum = 0.0;
+        for (int tid = 0; tid < nthreads; ++tid) {
+            WSQueue& q = ws_queues[tid];
+            q.head.store(beginIndex+it, std::memory_order_relaxed);
+            const double wend = wtot * (tid+1) / nthreads;
+            while (it < ntiles && (tid == nthreads-1 || wsum + 0.5*w[it] <= wend)) {
+                wsum += w[it++];
+            }
+            q.tail.store(beginIndex+it, std::memory_order_relaxed);
+            q.finish = 0.0;
+            q.nsteals = 0;
+        }
+        ws_nfinished.store(0);
+    }
+    // implicit barrier of omp single
+
+    currentIndex = WSNext();
+#endif
+}
+
+int
+MFIter::WSNext () noexcept
+{
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+    WSQueue& q = ws_queues[tid];
+    {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        const int h = q.head.load(std::memory_order_relaxed);
+        if (h < q.tail.load(std::memory_order_relaxed)) {
+            q.head.store(h+1, std::memory_order_relaxed);
+            return h;
+        }
+    }
+
+    while (true)
+    {
+        int victim = -1;
+        int nmax = 0;
+        for (int i = 0; i < ws_nqueues; ++i) {
+            if (i != tid) {
+                const int n = ws_queues[i].tail.load(std::memory_order_relaxed)
+                    -         ws_queues[i].head.load(std::memory_order_relaxed);
+                if (n > nmax) {
+                    nmax = n;
+                    victim = i;
+                }
+            }
+        }
+
+        if (victim < 0) return endIndex;
+
+        int b, e;
+        {
+            WSQueue& v = ws_queues[victim];
+            std::lock_guard<std::mutex> lock(v.mutex);
+            const int h = v.head.load(std::memory_order_relaxed);
+            e = v.tail.load(std::memory_order_relaxed);
+            const int n = e - h;
+            if (n <= 0) continue;
+            b = e - (n+1)/2;
+            v.tail.store(b, std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.head.store(b+1, std::memory_order_relaxed);
+        q.tail.store(e, std::memory_order_relaxed);
+        ++q.nsteals;
+        return b;
+    }
+#else
+    return endIndex;
+#endif
+}
+
+void
+MFIter::WSFinalize () noexcept
+{
+#ifdef _OPENMP
+    ws_queues[omp_get_thread_num()].finish = amrex::second();
+    // The last thread to finish knows the finish times of all threads.
+    if (++ws_nfinished == ws_nqueues)
+    {
+        double tmax = 0.0;
+        for (int i = 0; i < ws_nqueues; ++i) {
+            tmax = std::max(tmax, ws_queues[i].finish);
+        }
+        double idle = 0.0;
+        long nsteals = 0;
+        for (int i = 0; i < ws_nqueues; ++i) {
+            idle += tmax - ws_queues[i].finish;
+            nsteals += ws_queues[i].nsteals;
+        }
+        ++wsStats.loops;
+        wsStats.steals += nsteals;
+        wsStats.idle_time += idle;
+#ifdef AMREX_TINY_PROFILING
+        TinyProfiler::AddCounter("MFIter::WorkStealing::Loops", 1.0);
+        TinyProfiler::AddCounter("MFIter::WorkStealing::Steals", static_cast<double>(nsteals));
+        TinyProfiler::AddCounter("MFIter::WorkStealing::IdleTime", idle);
+#endif
+    }
+#endif
+}
+
 void 
 MFIter::Initialize ()
 {
@@ -288,6 +661,10 @@ MFIter::Initialize ()
             {
                 beginIndex = omp_get_thread_num();
             }
+            else if (work_stealing)
+            {
+                // The tiles are handed out by WSNext.
+            }
             else
             {
                 int tid = omp_get_thread_num();
@@ -462,6 +839,26 @@ MFIter::grownnodaltilebox (int dir, IntVect const& a_ng) const noexcept
     return bx;
 }
 
+Box
+MFIter::coretilebox (const IntVect& nghost) const noexcept
+{
+    Box bx = tilebox();
+    bx &= amrex::grow(validbox(), -nghost);
+    return bx;
+}
+
+BoxList
+MFIter::rimtileboxes (const IntVect& nghost) const
+{
+    const Box& bx = tilebox();
+    const Box& cbx = coretilebox(nghost);
+    if (cbx.ok()) {
+        return amrex::boxDiff(bx, cbx);
+    } else {
+        return BoxList(bx);
+    }
+}
+
 void
 MFIter::operator++ () noexcept
 {
@@ -471,6 +868,10 @@ MFIter::operator++ () noexcept
 #pragma omp atomic capture
         currentIndex = nextDynamicIndex++;
     }
+    else if (work_stealing)
+    {
+        currentIndex = WSNext();
+    }
     else
 #endif
     {
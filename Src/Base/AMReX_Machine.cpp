@@ -8,6 +8,10 @@
 #include <map>
 #include <unordered_map>
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 #include <AMReX_Print.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_ParallelReduce.H>
@@ -211,6 +215,21 @@ class Machine
         get_params();
         get_machine_envs();
         node_ids = get_node_ids();
+        // DistributionMapping looks up the topology in places that are not
+        // collective over all ranks, so get it here if it is going to be used.
+        if (flag_need_topology) {
+            get_topology();
+        }
+    }
+
+    const Vector<int>& topology_node_ids () {
+        if (!has_topology) get_topology();
+        return topo_node_ids;
+    }
+
+    const Vector<int>& topology_numa_ids () {
+        if (!has_topology) get_topology();
+        return topo_numa_ids;
     }
 
     // find a compact neighborhood of size rank_n in the current ParallelContext subgroup
@@ -321,6 +340,14 @@ class Machine
     int my_node_id;
     Vector<int> node_ids;
 
+    // shared-memory node and NUMA domain of every rank in the job
+    int simulated_node_size = 0;
+    int simulated_numa_size = 0;
+    bool flag_need_topology = false;
+    bool has_topology = false;
+    Vector<int> topo_node_ids;
+    Vector<int> topo_numa_ids;
+
     NeighborhoodCache nbh_cache;
 
     void get_params ()
@@ -328,6 +355,14 @@ class Machine
         ParmParse pp("machine");
         pp.query("verbose", flag_verbose);
         pp.query("very_verbose", flag_very_verbose);
+        pp.query("simulated_node_size", simulated_node_size);
+        pp.query("simulated_numa_size", simulated_numa_size);
+
+        int topology_aware = 0, report_strategies = 0;
+        ParmParse pp_dm("DistributionMapping");
+        pp_dm.query("topology_aware", topology_aware);
+        pp_dm.query("report_strategies", report_strategies);
+        flag_need_topology = topology_aware || report_strategies;
     }
 
     std::string get_env_str (std::string env_key)
@@ -429,6 +464,86 @@ class Machine
         return ids;
     }
 
+    // get the NUMA node of the cpu this rank is running on, -1 if unknown
+    int get_my_numa_node ()
+    {
+#ifdef __linux__
+        const int cpu = sched_getcpu();
+        if (cpu < 0) return -1;
+        for (int node = 0; ; ++node) {
+            std::ifstream ifs("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!ifs.good()) break;
+            // cpulist looks like "0-3,8-11"
+            std::string range;
+            while (std::getline(ifs, range, ',')) {
+                int lo = -1, hi = -1;
+                auto dash = range.find('-');
+                if (dash == std::string::npos) {
+                    lo = hi = std::stoi(range);
+                } else {
+                    lo = std::stoi(range.substr(0, dash));
+                    hi = std::stoi(range.substr(dash + 1));
+                }
+                if (cpu >= lo && cpu <= hi) return node;
+            }
+        }
+#endif
+        return -1;
+    }
+
+    // find the shared-memory node and NUMA domain of every rank in the job
+    // this is collective over ALL ranks in the job
+    void get_topology ()
+    {
+        BL_PROFILE("Machine::get_topology()");
+
+        has_topology = true;
+        const int nprocs = ParallelDescriptor::NProcs();
+        topo_node_ids.resize(nprocs, 0);
+        topo_numa_ids.resize(nprocs, 0);
+#ifdef BL_USE_MPI
+        const int myproc = ParallelDescriptor::MyProc();
+        int node_id = 0, node_rank = 0;
+        if (simulated_node_size > 0) {
+            node_id = myproc / simulated_node_size;
+            node_rank = myproc % simulated_node_size;
+        } else {
+#if (MPI_VERSION >= 3)
+            MPI_Comm node_comm;
+            MPI_Comm_split_type(ParallelContext::CommunicatorAll(), MPI_COMM_TYPE_SHARED,
+                                myproc, MPI_INFO_NULL, &node_comm);
+            // the node ID is the lowest global rank on the node
+            MPI_Allreduce(&myproc, &node_id, 1, MPI_INT, MPI_MIN, node_comm);
+            MPI_Comm_rank(node_comm, &node_rank);
+            MPI_Comm_free(&node_comm);
+#else
+            node_id = myproc;
+#endif
+        }
+
+        int numa_id = 0;
+        if (simulated_numa_size > 0) {
+            numa_id = node_rank / simulated_numa_size;
+        } else {
+            numa_id = std::max(get_my_numa_node(), 0);
+        }
+
+        ParallelAllGather::AllGather(node_id, topo_node_ids.data(), ParallelContext::CommunicatorAll());
+        ParallelAllGather::AllGather(numa_id, topo_numa_ids.data(), ParallelContext::CommunicatorAll());
+#endif
+        if (flag_verbose) {
+            std::map<std::pair<int,int>, Vector<int>> domain_ranks;
+            for (int i = 0; i < nprocs; ++i) {
+                domain_ranks[std::make_pair(topo_node_ids[i], topo_numa_ids[i])].push_back(i);
+            }
+            Print() << "Node: NUMA: Ranks:" << std::endl;
+            for (const auto & p : domain_ranks) {
+                Print() << "  " << p.first.first << ": " << p.first.second
+                        << ": " << to_str(p.second) << std::endl;
+            }
+        }
+    }
+
     // do a local search starting at current node
     std::pair<Vector<int>, double>
     baseline_score(const Vector<int> & sg_node_ids, int nbh_rank_n)
@@ -588,4 +703,14 @@ Vector<int> find_best_nbh (int rank_n, bool flag_local_ranks) {
     return the_machine->find_best_nbh(rank_n, flag_local_ranks);
 }
 
+const Vector<int>& node_ids () {
+    AMREX_ASSERT(the_machine);
+    return the_machine->topology_node_ids();
+}
+
+const Vector<int>& numa_ids () {
+    AMREX_ASSERT(the_machine);
+    return the_machine->topology_numa_ids();
+}
+
 }}
@@ -1,8 +1,10 @@
 
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 
 #include <AMReX_VisMF.H>
+#include <AMReX_AsyncOut.H>
 #include <AMReX_PlotFileUtil.H>
 
 #ifdef AMREX_USE_EB
@@ -228,6 +230,113 @@ WriteMultiLevelPlotfile (const std::string& plotfilename, int nlevels,
 //    VisMF::SetNOutFiles(saveNFiles);
 }
 
+std::future<WriteAsyncStatus>
+WriteMultiLevelPlotfileAsync (const std::string& plotfilename, int nlevels,
+                              const Vector<const MultiFab*>& mf,
+                              const Vector<std::string>& varnames,
+                              const Vector<Geometry>& geom, Real time, const Vector<int>& level_steps,
+                              const Vector<IntVect>& ref_ratio,
+                              const std::string &versionName,
+                              const std::string &levelPrefix,
+                              const std::string &mfPrefix,
+                              const Vector<std::string>& extra_dirs)
+{
+    BL_PROFILE("WriteMultiLevelPlotfileAsync()");
+
+    BL_ASSERT(nlevels <= mf.size());
+    BL_ASSERT(nlevels <= geom.size());
+    BL_ASSERT(nlevels <= ref_ratio.size()+1);
+    BL_ASSERT(nlevels <= level_steps.size());
+    BL_ASSERT(mf[0]->nComp() == varnames.size());
+
+    bool callBarrier(false);
+    PreBuildDirectorHierarchy(plotfilename, levelPrefix, nlevels, callBarrier);
+    if (!extra_dirs.empty()) {
+        for (const auto& d : extra_dirs) {
+            const std::string ed = plotfilename+"/"+d;
+            amrex::PreBuildDirectorHierarchy(ed, levelPrefix, nlevels, callBarrier);
+        }
+    }
+    ParallelDescriptor::Barrier();
+
+    // The header is made now and written later by the I/O process.
+    std::string header;
+    if (ParallelDescriptor::IOProcessor()) {
+        Vector<BoxArray> boxArrays(nlevels);
+        for (int level = 0; level < nlevels; ++level) {
+            boxArrays[level] = mf[level]->boxArray();
+        }
+        std::ostringstream HeaderFile;
+        WriteGenericPlotfileHeader(HeaderFile, nlevels, boxArrays, varnames,
+                                   geom, time, level_steps, ref_ratio, versionName, levelPrefix, mfPrefix);
+        header = HeaderFile.str();
+    }
+
+    // VisMF::WriteAsync copies the data into staging memory before it returns.
+    Vector<std::future<WriteAsyncStatus> > level_status;
+    for (int level = 0; level < nlevels; ++level)
+    {
+        const MultiFab* data;
+        std::unique_ptr<MultiFab> mf_tmp;
+        if (mf[level]->nGrow() > 0) {
+            mf_tmp.reset(new MultiFab(mf[level]->boxArray(),
+                                      mf[level]->DistributionMap(),
+                                      mf[level]->nComp(), 0, MFInfo(),
+                                      mf[level]->Factory()));
+            MultiFab::Copy(*mf_tmp, *mf[level], 0, 0, mf[level]->nComp(), 0);
+            data = mf_tmp.get();
+        } else {
+            data = mf[level];
+        }
+        level_status.push_back(VisMF::WriteAsync(*data, MultiFabFileFullPrefix(level, plotfilename,
+                                                                                levelPrefix, mfPrefix)));
+    }
+
+    // This task is queued after the level writes, so it does not hold a
+    // thread that they need.
+    const std::string HeaderFileName(plotfilename + "/Header");
+    auto task = std::make_shared<std::packaged_task<WriteAsyncStatus()> >(
+    [HeaderFileName, header = std::move(header), level_status = std::move(level_status)] () mutable
+        -> WriteAsyncStatus
+    {
+        Real tbegin = amrex::second();
+        if (!header.empty()) {
+            std::ofstream HeaderFile(HeaderFileName.c_str(), std::ofstream::out   |
+                                                             std::ofstream::trunc |
+                                                             std::ofstream::binary);
+            if ( ! HeaderFile.good()) {
+                FileOpenFailed(HeaderFileName);
+            }
+            HeaderFile << header;
+        }
+        Real theader = amrex::second() - tbegin;
+
+        WriteAsyncStatus status;
+        status.nbytes = header.size();
+        status.nspins = 0;
+        status.t_total = theader;
+        status.t_header = theader;
+        status.t_spin = 0.0;
+        status.t_write = 0.0;
+        status.t_send = 0.0;
+        for (auto& f : level_status) {
+            WriteAsyncStatus s = f.get();
+            status.nbytes   += s.nbytes;
+            status.nspins   += s.nspins;
+            status.t_total  += s.t_total;
+            status.t_header += s.t_header;
+            status.t_spin   += s.t_spin;
+            status.t_write  += s.t_write;
+            status.t_send   += s.t_send;
+        }
+        return status;
+    });
+
+    auto af = task->get_future();
+    AsyncOut::Submit([task] () { (*task)(); });
+    return af;
+}
+
 // write a plotfile to disk given:
 // -plotfile name
 // -vector of MultiFabs
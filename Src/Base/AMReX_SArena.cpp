@@ -0,0 +1,187 @@
+#include <AMReX_SArena.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX.H>
+
+namespace amrex {
+
+SArena::SArena (std::size_t segment_size)
+{
+    const std::size_t a = 16;
+    m_size = ((segment_size+a-1)/a)*a;
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    m_node_rank.resize(nprocs, -1);
+
+#if defined(BL_USE_MPI) && (MPI_VERSION >= 3)
+    MPI_Comm comm = ParallelContext::CommunicatorAll();
+    const int myproc = ParallelDescriptor::MyProc();
+
+    BL_MPI_REQUIRE( MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, myproc,
+                                        MPI_INFO_NULL, &m_node_comm) );
+
+    MPI_Info info;
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "alloc_shared_noncontig", "true");
+    BL_MPI_REQUIRE( MPI_Win_allocate_shared(m_size, 1, info, m_node_comm,
+                                            &m_baseptr, &m_win) );
+    MPI_Info_free(&info);
+
+    // Passive target epoch for the lifetime of the window, so that
+    // MPI_Win_sync can be used for memory barriers.
+    BL_MPI_REQUIRE( MPI_Win_lock_all(MPI_MODE_NOCHECK, m_win) );
+
+    int node_nprocs;
+    MPI_Comm_size(m_node_comm, &node_nprocs);
+    m_peer_base.resize(node_nprocs);
+    for (int r = 0; r < node_nprocs; ++r) {
+        MPI_Aint sz;
+        int disp;
+        char* p = nullptr;
+        BL_MPI_REQUIRE( MPI_Win_shared_query(m_win, r, &sz, &disp, &p) );
+        m_peer_base[r] = p;
+    }
+
+    Vector<int> node_globals(node_nprocs);
+    BL_MPI_REQUIRE( MPI_Allgather(&myproc, 1, MPI_INT, node_globals.data(), 1, MPI_INT,
+                                  m_node_comm) );
+    for (int r = 0; r < node_nprocs; ++r) {
+        m_node_rank[node_globals[r]] = r;
+    }
+#else
+    m_baseptr = static_cast<char*>(allocate_system(m_size));
+    m_peer_base.push_back(m_baseptr);
+    m_node_rank[0] = 0;
+#endif
+
+    if (m_size > 0) {
+        m_free[0] = m_size;
+    }
+
+    if (amrex::Verbose()) {
+        amrex::Print() << "SArena: Allocating " << m_size << " bytes per process\n";
+    }
+}
+
+SArena::~SArena ()
+{
+    for (auto const& kv : m_system) {
+        deallocate_system(kv.first, kv.second);
+    }
+#if defined(BL_USE_MPI) && (MPI_VERSION >= 3)
+    MPI_Win_unlock_all(m_win);
+    MPI_Win_free(&m_win);
+    MPI_Comm_free(&m_node_comm);
+#else
+    deallocate_system(m_baseptr, m_size);
+#endif
+}
+
+void*
+SArena::alloc (std::size_t nbytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ++m_num_allocs;
+    nbytes = Arena::align(nbytes == 0 ? 1 : nbytes);
+
+    for (auto it = m_free.begin(); it != m_free.end(); ++it)
+    {
+        if (it->second >= nbytes)
+        {
+            const std::ptrdiff_t off = it->first;
+            const std::size_t left = it->second - nbytes;
+            m_free.erase(it);
+            if (left > 0) {
+                m_free[off+nbytes] = left;
+            }
+            m_used[off] = nbytes;
+            return m_baseptr + off;
+        }
+    }
+
+    // Out of shared memory.  Use the system malloc as backup.
+    void* p = allocate_system(nbytes);
+    m_system[p] = nbytes;
+    return p;
+}
+
+void
+SArena::free (void* p)
+{
+    if (p == nullptr) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!isShared(p))
+    {
+        auto r = m_system.find(p);
+        if (r == m_system.end()) {
+            amrex::Abort("SArena::free: unknown pointer");
+        }
+        deallocate_system(r->first, r->second);
+        m_system.erase(r);
+        return;
+    }
+
+    const std::ptrdiff_t off = static_cast<char*>(p) - m_baseptr;
+    auto used = m_used.find(off);
+    if (used == m_used.end()) {
+        amrex::Abort("SArena::free: unknown pointer");
+    }
+
+    auto it = m_free.emplace(off, used->second).first;
+    m_used.erase(used);
+
+    // Coalesce with the free neighbors.
+    auto next = std::next(it);
+    if (next != m_free.end() && it->first + static_cast<std::ptrdiff_t>(it->second) == next->first) {
+        it->second += next->second;
+        m_free.erase(next);
+    }
+    if (it != m_free.begin()) {
+        auto prev = std::prev(it);
+        if (prev->first + static_cast<std::ptrdiff_t>(prev->second) == it->first) {
+            prev->second += it->second;
+            m_free.erase(it);
+        }
+    }
+}
+
+std::size_t
+SArena::freeMem () const
+{
+    std::size_t r = 0;
+    for (auto const& kv : m_free) {
+        r += kv.second;
+    }
+    return r;
+}
+
+void
+SArena::sync (const Vector<int>& to, const Vector<int>& from, int tag)
+{
+#if defined(BL_USE_MPI) && (MPI_VERSION >= 3)
+    const int nfrom = from.size();
+    const int nto = to.size();
+    if (nfrom + nto == 0) return;
+
+    Vector<MPI_Request> reqs(nfrom+nto);
+    for (int i = 0; i < nfrom; ++i) {
+        BL_MPI_REQUIRE( MPI_Irecv(nullptr, 0, MPI_CHAR, from[i], tag, m_node_comm, &reqs[i]) );
+    }
+    MPI_Win_sync(m_win);
+    for (int i = 0; i < nto; ++i) {
+        BL_MPI_REQUIRE( MPI_Isend(nullptr, 0, MPI_CHAR, to[i], tag, m_node_comm, &reqs[nfrom+i]) );
+    }
+    BL_MPI_REQUIRE( MPI_Waitall(nfrom+nto, reqs.data(), MPI_STATUSES_IGNORE) );
+    MPI_Win_sync(m_win);
+#else
+    amrex::ignore_unused(to, from, tag);
+#endif
+}
+
+}
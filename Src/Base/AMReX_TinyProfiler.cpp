@@ -23,6 +23,7 @@ std::vector<std::string>          TinyProfiler::regionstack;
 std::deque<std::tuple<double,double,std::string*> > TinyProfiler::ttstack;
 std::map<std::string,std::map<std::string, TinyProfiler::Stats> > TinyProfiler::statsmap;
 double TinyProfiler::t_init = std::numeric_limits<double>::max();
+std::map<std::string,double> TinyProfiler::countermap;
 
 namespace {
     std::set<std::string> improperly_nested_timers;
@@ -158,6 +159,7 @@ TinyProfiler::Finalize (bool bFlushing) noexcept
 
     // make a local copy so that any functions call after this will not be recorded in the local copy.
     auto lstatsmap = statsmap;
+    auto lcountermap = countermap;
 
     bool properly_nested = improperly_nested_timers.size() == 0;
     ParallelDescriptor::ReduceBoolAnd(properly_nested);
@@ -228,6 +230,100 @@ TinyProfiler::Finalize (bool bFlushing) noexcept
             amrex::Print() << "END REGION " << kv.first << "\n";
         }
     }
+
+    PrintCounters(lcountermap);
+}
+
+void
+TinyProfiler::AddCounter (const std::string& name, double value) noexcept
+{
+#ifdef _OPENMP
+#pragma omp critical(tinyprofiler_counter)
+#endif
+    countermap[name] += value;
+}
+
+void
+TinyProfiler::PrintCounters (std::map<std::string,double>& counters)
+{
+    {
+        Vector<std::string> localStrings, syncedStrings;
+        bool alreadySynced;
+
+        for (auto const& kv : counters) {
+            localStrings.push_back(kv.first);
+        }
+
+        amrex::SyncStrings(localStrings, syncedStrings, alreadySynced);
+
+        if (! alreadySynced) {
+            for (auto const& s : syncedStrings) {
+                counters.insert(std::make_pair(s, 0.0));
+            }
+        }
+    }
+
+    if (counters.empty()) return;
+
+    int nprocs = ParallelDescriptor::NProcs();
+    int ioproc = ParallelDescriptor::IOProcessorNumber();
+
+    // All the counters in one Gather.  The names are synced, so the maps
+    // are in the same order on all processes.
+    const int ncounters = counters.size();
+    std::vector<double> local, vals(nprocs*ncounters);
+    for (auto const& kv : counters) {
+        local.push_back(kv.second);
+    }
+    if (nprocs == 1) {
+        vals = local;
+    } else {
+        ParallelDescriptor::Gather(local.data(), ncounters, vals.data(), ncounters, ioproc);
+    }
+
+    int maxnamelen = std::string("Counter").size();
+    for (auto const& kv : counters) {
+        maxnamelen = std::max(maxnamelen, int(kv.first.size()));
+    }
+    int wt = 12;
+    const std::string hline(maxnamelen+(wt+2)*3,'-');
+
+    if (ParallelDescriptor::IOProcessor()) {
+        amrex::OutStream() << std::setfill(' ') << std::setprecision(4)
+                           << "\n" << hline << "\n"
+                           << std::left << std::setw(maxnamelen) << "Counter"
+                           << std::right
+                           << std::setw(wt+2) << "Min"
+                           << std::setw(wt+2) << "Avg"
+                           << std::setw(wt+2) << "Max"
+                           << "\n" << hline << "\n";
+    }
+
+    int ic = 0;
+    for (auto const& kv : counters)
+    {
+        if (ParallelDescriptor::IOProcessor()) {
+            double vmin = std::numeric_limits<double>::max(), vavg = 0.0, vmax = std::numeric_limits<double>::lowest();
+            for (int i = 0; i < nprocs; ++i) {
+                const double x = vals[i*ncounters+ic];
+                vmin = std::min(vmin, x);
+                vavg += x;
+                vmax = std::max(vmax, x);
+            }
+            vavg /= nprocs;
+            amrex::OutStream() << std::setprecision(4) << std::left
+                               << std::setw(maxnamelen) << kv.first
+                               << std::right
+                               << std::setw(wt+2) << vmin
+                               << std::setw(wt+2) << vavg
+                               << std::setw(wt+2) << vmax << "\n";
+        }
+        ++ic;
+    }
+
+    if (ParallelDescriptor::IOProcessor()) {
+        amrex::OutStream() << hline << "\n" << std::endl;
+    }
 }
 
 void
@@ -17,6 +17,9 @@
 #include <AMReX_NFiles.H>
 #include <AMReX_FPC.H>
 #include <AMReX_FabArrayUtility.H>
+#include <AMReX_AsyncOut.H>
+#include <AMReX_FabCompression.H>
+#include <AMReX_ParallelReduce.H>
 
 namespace amrex {
 
@@ -28,6 +31,7 @@ std::map<std::string, VisMF::PersistentIFStream> VisMF::persistentIFStreams;
 
 int VisMF::verbose(0);
 VisMF::Header::Version VisMF::currentVersion(VisMF::Header::Version_v1);
+std::string VisMF::compression("shuffle_lz");
 bool VisMF::groupSets(false);
 bool VisMF::setBuf(true);
 bool VisMF::useSingleRead(false);
@@ -75,6 +79,7 @@ VisMF::Initialize ()
     if(headerVersion != currentVersion) {
       currentVersion = static_cast<VisMF::Header::Version> (headerVersion);
     }
+    pp.query("compression", compression);
 
     pp.query("groupsets", groupSets);
     pp.query("setbuf", setBuf);
@@ -284,7 +289,8 @@ operator<< (std::ostream        &os,
     os << hd.m_fod      << '\n';
 
     if(hd.m_vers == VisMF::Header::Version_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1)
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       os << hd.m_min      << '\n';
       os << hd.m_max      << '\n';
@@ -316,6 +322,16 @@ operator<< (std::ostream        &os,
       }
     }
 
+    if(hd.m_vers == VisMF::Header::Compressed_v1) {
+      // ---- the codecs compress native reals
+      os << FPC::NativeRealDescriptor() << '\n';
+      os << hd.m_codec << '\n';
+      os << hd.m_csize.size() << '\n';
+      for(int i(0); i < hd.m_csize.size(); ++i) {
+        os << hd.m_csize[i] << '\n';
+      }
+    }
+
     os.flags(oflags);
     os.precision(oldPrec);
 
@@ -368,7 +384,8 @@ operator>> (std::istream  &is,
     BL_ASSERT(hd.m_ba.size() == hd.m_fod.size());
 
     if(hd.m_vers == VisMF::Header::Version_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1)
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       is >> hd.m_min;
       is >> hd.m_max;
@@ -400,6 +417,18 @@ operator>> (std::istream  &is,
       is >> hd.m_writtenRD;
     }
 
+    if(hd.m_vers == VisMF::Header::Compressed_v1) {
+      is >> hd.m_writtenRD;
+      is >> hd.m_codec;
+      long ncsize(0);
+      is >> ncsize;
+      BL_ASSERT(ncsize == hd.m_ba.size());
+      hd.m_csize.resize(ncsize);
+      for(long i(0); i < ncsize; ++i) {
+        is >> hd.m_csize[i];
+      }
+    }
+
 
     if( ! is.good()) {
         amrex::Error("Read of VisMF::Header failed");
@@ -689,6 +718,11 @@ VisMF::Header::Header (const FabArray<FArrayBox>& mf,
       return;
     }
 
+    if(version == Compressed_v1) {
+      m_codec = VisMF::GetCompression();
+      m_csize.resize(m_ba.size(), 0);
+    }
+
     if(calcMinMax) {
       CalculateMinMax(mf,0, comm);
     }
@@ -979,12 +1013,43 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 
     bool oldHeader(currentVersion == VisMF::Header::Version_v1);
 
+    // ---- compress the fabs before waiting for a turn to write
+    bool compressed(currentVersion == VisMF::Header::Compressed_v1);
+    Vector<int> localIndex;
+    Vector< Vector<char> > compressedData;
+    if(compressed) {
+      std::unique_ptr<FabCodec> codec(FabCompression::Create(compression));
+      hdr.m_codec = codec->spec();
+      for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        localIndex.push_back(mfi.index());
+      }
+      compressedData.resize(localIndex.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for(int i = 0; i < localIndex.size(); ++i) {
+        const FArrayBox &fab = mf[localIndex[i]];
+        codec->compress(fab.dataPtr(), fab.box().numPts() * mf.nComp(), compressedData[i]);
+      }
+      for(int i(0); i < localIndex.size(); ++i) {
+        hdr.m_csize[localIndex[i]] = compressedData[i].size();
+      }
+    }
+
       if(useSparseFPP) {
         nfi.SetSparseFPP(procsWithDataVector);
       } else if(useDynamicSetSelection) {
         nfi.SetDynamic();
       }
       for( ; nfi.ReadyToWrite(); ++nfi) {
+          if(compressed) {
+            for(int i(0); i < compressedData.size(); ++i) {
+              nfi.Stream().write(compressedData[i].dataPtr(), compressedData[i].size());
+              bytesWritten += compressedData[i].size();
+            }
+            nfi.Stream().flush();
+            continue;
+          }
 	  // ---- find the total number of bytes including fab headers if needed
           const FABio &fio = FArrayBox::getFABio();
           int whichRDBytes(whichRD->numBytes()), nFABs(0);
@@ -1074,7 +1139,8 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     }
 
     if(currentVersion == VisMF::Header::Version_v1 ||
-       currentVersion == VisMF::Header::NoFabHeaderMinMax_v1)
+       currentVersion == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       currentVersion == VisMF::Header::Compressed_v1)
     {
       hdr.CalculateMinMax(mf, coordinatorProc);
     }
@@ -1223,6 +1289,11 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
       int whichRDBytes(whichRD->numBytes());
       int nComps(mf.nComp());
 
+      if(whichVersion == VisMF::Header::Compressed_v1) {
+        // ---- only the owners know the compressed sizes
+        ParallelReduce::Sum(hdr.m_csize.dataPtr(), hdr.m_csize.size(), coordinatorProc, comm);
+      }
+
       if(myProc == coordinatorProc) {   // ---- calculate offsets
 	const BoxArray &mfBA = mf.boxArray();
 	const DistributionMapping &mfDM = mf.DistributionMap();
@@ -1279,8 +1350,12 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 	      for(int i(0); i < index.size(); ++i) {
                  hdr.m_fod[index[i]].m_name = whichFileName;
                  hdr.m_fod[index[i]].m_head = currentOffset[whichFileNumber];
-                 currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
-	                                           + fabHeaderBytes[index[i]];
+                 if(hdr.m_vers == VisMF::Header::Compressed_v1) {
+                   currentOffset[whichFileNumber] += hdr.m_csize[index[i]];
+                 } else {
+                   currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
+	                                             + fabHeaderBytes[index[i]];
+                 }
               }
             }
 	  }
@@ -1355,6 +1430,25 @@ VisMF::~VisMF ()
 }
 
 
+namespace {
+// ---- read and decompress all the components of fab idx, the stream is at its offset
+void
+ReadCompressedFAB (std::istream &is, const VisMF::Header &hdr, int idx, FArrayBox &fab)
+{
+    if(hdr.m_writtenRD != FPC::NativeRealDescriptor()) {
+      amrex::Abort("VisMF: compressed data were written with a different real format");
+    }
+    std::unique_ptr<FabCodec> codec(FabCompression::Create(hdr.m_codec));
+    Vector<char> cdata(hdr.m_csize[idx]);
+    is.read(cdata.dataPtr(), cdata.size());
+    if( ! is.good()) {
+      amrex::Error("VisMF: failed to read compressed fab");
+    }
+    codec->decompress(cdata.dataPtr(), cdata.size(), fab.dataPtr(),
+                      fab.box().numPts() * fab.nComp());
+}
+}
+
 FArrayBox*
 VisMF::readFAB (int                  idx,
                 const std::string   &mf_name,
@@ -1381,6 +1475,14 @@ VisMF::readFAB (int                  idx,
       } else {
         fab->readFrom(*infs, whichComp);
       }
+    } else if(hdr.m_vers == Header::Compressed_v1) {
+      if(whichComp == -1) {    // ---- read all components
+        ReadCompressedFAB(*infs, hdr, idx, *fab);
+      } else {                 // ---- the codecs compress whole fabs
+        FArrayBox allComps(fab_box, hdr.m_ncomp);
+        ReadCompressedFAB(*infs, hdr, idx, allComps);
+        fab->copy(allComps, whichComp, 0, 1);
+      }
     } else {
       if(whichComp == -1) {    // ---- read all components
 	if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
@@ -1425,7 +1527,9 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(NoFabHeader(hdr)) {
+    if(hdr.m_vers == Header::Compressed_v1) {
+      ReadCompressedFAB(*infs, hdr, idx, fab);
+    } else if(NoFabHeader(hdr)) {
       if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
         infs->read((char *) fab.dataPtr(), fab.nBytes());
       } else {
@@ -1507,7 +1611,7 @@ VisMF::Read (FabArray<FArrayBox> &mf,
   int nProcs(ParallelDescriptor::NProcs());
   bool noFabHeader(NoFabHeader(hdr));
 
-  if(noFabHeader && useSynchronousReads) {
+  if(noFabHeader && useSynchronousReads && hdr.m_vers != VisMF::Header::Compressed_v1) {
 
     // ---- This code is only for reading in file order
     bool doConvert(hdr.m_writtenRD != FPC::NativeRealDescriptor());
@@ -2052,7 +2156,8 @@ VisMF::clear ()
 bool VisMF::NoFabHeader(const VisMF::Header &hdr) {
   if(hdr.m_vers == VisMF::Header::NoFabHeader_v1       ||
     hdr.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-    hdr.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+    hdr.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+    hdr.m_vers == VisMF::Header::Compressed_v1)
   {
     return true;
   }
@@ -2293,6 +2398,9 @@ VisMF::WriteAsync (const FabArray<FArrayBox>& mf, const std::string& mf_name)
     }
 #endif
 
+    // Bound the staging memory held by the pending writes.
+    AsyncOut::Reserve(total_bytes);
+
     std::unique_ptr<char,DataDeleter> alldata((char*)(The_Pinned_Arena()->alloc(total_bytes)),
                                               DataDeleter(The_Pinned_Arena()));
     char* p = alldata.get();
@@ -2324,8 +2432,8 @@ VisMF::WriteAsync (const FabArray<FArrayBox>& mf, const std::string& mf_name)
         p += nreals * whichRD.numBytes();
     }
 
-    auto af = std::async(std::launch::async,
-    [=] (std::unique_ptr<char,DataDeleter> d, Header h, Vector<int64_t> const& gdata)
+    auto task = std::make_shared<std::packaged_task<WriteAsyncStatus()> >(
+    [=, d = std::move(alldata), h = std::move(hdr), gdata = std::move(globaldata)] () mutable
          -> WriteAsyncStatus
     {
         Real tbegin = amrex::second();
@@ -2465,9 +2573,10 @@ VisMF::WriteAsync (const FabArray<FArrayBox>& mf, const std::string& mf_name)
         status.t_write = t2-t1;
         status.t_send = tend-t2;
         return status;
-    },
-    std::move(alldata), std::move(hdr), std::move(globaldata));
+    });
 
+    auto af = task->get_future();
+    AsyncOut::Submit([task] () { (*task)(); }, total_bytes);
     return af;
 }
 
@@ -30,6 +30,7 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
 
     m_a_coeffs.resize(m_num_amr_levels);
     m_b_coeffs.resize(m_num_amr_levels);
+    m_coeffs_changed.resize(m_num_amr_levels, 1);
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
     {
         m_a_coeffs[amrlev].resize(m_num_mg_levels[amrlev]);
@@ -57,6 +58,8 @@ MLABecLaplacian::~MLABecLaplacian ()
 void
 MLABecLaplacian::setScalars (Real a, Real b) noexcept
 {
+    // The singularity of the operator and the bottom solver's matrix depend on the scalars.
+    if (a != m_a_scalar || b != m_b_scalar) m_needs_update = true;
     m_a_scalar = a;
     m_b_scalar = b;
     if (a == 0.0)
@@ -64,6 +67,7 @@ MLABecLaplacian::setScalars (Real a, Real b) noexcept
         for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
         {
             m_a_coeffs[amrlev][0].setVal(0.0);
+            m_coeffs_changed[amrlev] = 1;
         }
     }
 }
@@ -72,6 +76,7 @@ void
 MLABecLaplacian::setACoeffs (int amrlev, const MultiFab& alpha)
 {
     MultiFab::Copy(m_a_coeffs[amrlev][0], alpha, 0, 0, 1, 0);
+    m_coeffs_changed[amrlev] = 1;
     m_needs_update = true;
 }
 
@@ -79,6 +84,7 @@ void
 MLABecLaplacian::setACoeffs (int amrlev, Real alpha)
 {
     m_a_coeffs[amrlev][0].setVal(alpha);
+    m_coeffs_changed[amrlev] = 1;
     m_needs_update = true;
 }
 
@@ -92,6 +98,7 @@ MLABecLaplacian::setBCoeffs (int amrlev,
             MultiFab::Copy(m_b_coeffs[amrlev][0][idim], *beta[idim], 0, icomp, 1, 0);
         }
     }
+    m_coeffs_changed[amrlev] = 1;
     m_needs_update = true;
 }
 
@@ -101,9 +108,12 @@ MLABecLaplacian::setBCoeffs (int amrlev, Real beta)
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         m_b_coeffs[amrlev][0][idim].setVal(beta);
     }
+    m_coeffs_changed[amrlev] = 1;
     m_needs_update = true;
 }
 
+// Only the AMR levels whose coefficients have changed, and the levels
+// below them, are averaged down.
 void
 MLABecLaplacian::averageDownCoeffs ()
 {
@@ -111,18 +121,24 @@ MLABecLaplacian::averageDownCoeffs ()
 
     for (int amrlev = m_num_amr_levels-1; amrlev > 0; --amrlev)
     {
-        auto& fine_a_coeffs = m_a_coeffs[amrlev];
-        auto& fine_b_coeffs = m_b_coeffs[amrlev];
+        if (m_coeffs_changed[amrlev])
+        {
+            auto& fine_a_coeffs = m_a_coeffs[amrlev];
+            auto& fine_b_coeffs = m_b_coeffs[amrlev];
 
-        averageDownCoeffsSameAmrLevel(fine_a_coeffs, fine_b_coeffs);
-        averageDownCoeffsToCoarseAmrLevel(amrlev);
+            averageDownCoeffsSameAmrLevel(amrlev, fine_a_coeffs, fine_b_coeffs);
+            averageDownCoeffsToCoarseAmrLevel(amrlev);
+            m_coeffs_changed[amrlev-1] = 1;
+        }
     }
 
-    averageDownCoeffsSameAmrLevel(m_a_coeffs[0], m_b_coeffs[0]);
+    if (m_coeffs_changed[0]) {
+        averageDownCoeffsSameAmrLevel(0, m_a_coeffs[0], m_b_coeffs[0]);
+    }
 }
 
 void
-MLABecLaplacian::averageDownCoeffsSameAmrLevel (Vector<MultiFab>& a,
+MLABecLaplacian::averageDownCoeffsSameAmrLevel (int amrlev, Vector<MultiFab>& a,
                                                 Vector<Array<MultiFab,AMREX_SPACEDIM> >& b)
 {
     int nmglevs = a.size();
@@ -132,39 +148,75 @@ MLABecLaplacian::averageDownCoeffsSameAmrLevel (Vector<MultiFab>& a,
         {
             a[mglev].setVal(0.0);
         }
-        else
-        {
-            amrex::average_down(a[mglev-1], a[mglev], 0, 1, mg_coarsen_ratio);
-        }
-        
-        Vector<const MultiFab*> fine {AMREX_D_DECL(&(b[mglev-1][0]),
-                                                   &(b[mglev-1][1]),
-                                                   &(b[mglev-1][2]))};
-        Vector<MultiFab*> crse {AMREX_D_DECL(&(b[mglev][0]),
-                                             &(b[mglev][1]),
-                                             &(b[mglev][2]))};
-        IntVect ratio {mg_coarsen_ratio};
-        amrex::average_down_faces(fine, crse, ratio, 0);
+        averageDownCoeffsCfine(amrlev, mglev, m_a_scalar != 0.0,
+                               a[mglev-1], b[mglev-1], a[mglev], b[mglev]);
     }
 }
 
 void
 MLABecLaplacian::averageDownCoeffsToCoarseAmrLevel (int flev)
 {
-    auto& fine_a_coeffs = m_a_coeffs[flev  ].back();
-    auto& fine_b_coeffs = m_b_coeffs[flev  ].back();
-    auto& crse_a_coeffs = m_a_coeffs[flev-1].front();
-    auto& crse_b_coeffs = m_b_coeffs[flev-1].front();
-
-    if (m_a_scalar != 0.0) {
-        // We coarsen from the back of flev to the front of flev-1.
-        // So we use mg_coarsen_ratio.
-        amrex::average_down(fine_a_coeffs, crse_a_coeffs, 0, 1, mg_coarsen_ratio);
+    // We coarsen from the back of flev to the front of flev-1.
+    // So we use mg_coarsen_ratio.  MG level 0 of flev is never a
+    // coarse MG level, so its temporaries are free for this.
+    averageDownCoeffsCfine(flev, 0, m_a_scalar != 0.0,
+                           m_a_coeffs[flev  ].back(), m_b_coeffs[flev  ].back(),
+                           m_a_coeffs[flev-1].front(), m_b_coeffs[flev-1].front());
+}
+
+// Average the fine coefficients down to the coarse ones.  If the coarse
+// BoxArray is not the coarsened fine BoxArray (e.g., the coarse level is on
+// another AMR level or has been agglomerated), we average down to
+// temporaries on the coarsened fine BoxArray, which are kept for the next
+// update, and copy from them.
+void
+MLABecLaplacian::averageDownCoeffsCfine (int amrlev, int mglev, bool do_a,
+                                         const MultiFab& afine,
+                                         const Array<MultiFab,AMREX_SPACEDIM>& bfine,
+                                         MultiFab& acrse, Array<MultiFab,AMREX_SPACEDIM>& bcrse)
+{
+    IntVect ratio {mg_coarsen_ratio};
+
+    if (amrex::isMFIterSafe(acrse, afine))
+    {
+        if (do_a) {
+            amrex::average_down(afine, acrse, 0, 1, ratio);
+        }
+        amrex::average_down_faces(amrex::GetArrOfConstPtrs(bfine), amrex::GetArrOfPtrs(bcrse),
+                                  ratio, 0);
+        return;
     }
 
-    amrex::average_down_faces(amrex::GetArrOfConstPtrs(fine_b_coeffs),
-                              amrex::GetArrOfPtrs(crse_b_coeffs),
-                              mg_coarsen_ratio, 0);
+    if (m_a_coeffs_cfine.empty()) {
+        m_a_coeffs_cfine.resize(m_num_amr_levels);
+        m_b_coeffs_cfine.resize(m_num_amr_levels);
+    }
+    if (m_a_coeffs_cfine[amrlev].empty()) {
+        m_a_coeffs_cfine[amrlev].resize(m_num_mg_levels[amrlev]);
+        m_b_coeffs_cfine[amrlev].resize(m_num_mg_levels[amrlev]);
+    }
+    auto& acfine = m_a_coeffs_cfine[amrlev][mglev];
+    auto& bcfine = m_b_coeffs_cfine[amrlev][mglev];
+    if (acfine == nullptr)
+    {
+        const DistributionMapping& dm = afine.DistributionMap();
+        acfine.reset(new MultiFab(amrex::coarsen(afine.boxArray(), ratio), dm, 1, 0));
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcfine[idim].reset(new MultiFab(amrex::coarsen(bfine[idim].boxArray(), ratio),
+                                            dm, bfine[idim].nComp(), 0));
+        }
+    }
+
+    if (do_a) {
+        amrex::average_down(afine, *acfine, 0, 1, ratio);
+        acrse.ParallelCopy(*acfine, 0, 0, 1);
+    }
+
+    Array<MultiFab*,AMREX_SPACEDIM> bc = amrex::GetArrOfPtrs(bcfine);
+    amrex::average_down_faces(amrex::GetArrOfConstPtrs(bfine), bc, ratio, 0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        bcrse[idim].ParallelCopy(*bc[idim], 0, 0, bcrse[idim].nComp());
+    }
 }
 
 void
@@ -173,6 +225,7 @@ MLABecLaplacian::applyMetricTermsCoeffs ()
 #if (AMREX_SPACEDIM != 3)
     for (int alev = 0; alev < m_num_amr_levels; ++alev)
     {
+        if (!m_coeffs_changed[alev]) continue; // already applied
         const int mglev = 0;
         applyMetricTerm(alev, mglev, m_a_coeffs[alev][mglev]);
         for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
@@ -190,43 +243,27 @@ MLABecLaplacian::prepareForSolve ()
 
     MLCellABecLap::prepareForSolve();
 
-#if (AMREX_SPACEDIM != 3)
-    applyMetricTermsCoeffs();
-#endif
-
-    averageDownCoeffs();
-
-    m_is_singular.clear();
-    m_is_singular.resize(m_num_amr_levels, false);
-    auto itlo = std::find(m_lobc[0].begin(), m_lobc[0].end(), BCType::Dirichlet);
-    auto ithi = std::find(m_hibc[0].begin(), m_hibc[0].end(), BCType::Dirichlet);
-    if (itlo == m_lobc[0].end() && ithi == m_hibc[0].end())
-    {  // No Dirichlet
-        for (int alev = 0; alev < m_num_amr_levels; ++alev)
-        {
-            if (m_domain_covered[alev])
-            {
-                if (m_a_scalar == 0.0)
-                {
-                    m_is_singular[alev] = true;
-                }
-                else
-                {
-                    Real asum = m_a_coeffs[alev].back().sum();
-                    Real amax = m_a_coeffs[alev].back().norm0();
-                    m_is_singular[alev] = (asum <= amax * 1.e-12);
-                }
-            }
-        }
-    }
-
-    m_needs_update = false;
+    updateCoeffs();
 }
 
 void
 MLABecLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& in) const
 {
     BL_PROFILE("MLABecLaplacian::Fapply()");
+    FapplyT(amrlev, mglev, out, in);
+}
+
+void
+MLABecLaplacian::FapplySP (int amrlev, int mglev, FloatMultiFab& out, const FloatMultiFab& in) const
+{
+    BL_PROFILE("MLABecLaplacian::FapplySP()");
+    FapplyT(amrlev, mglev, out, in);
+}
+
+template <typename MF>
+void
+MLABecLaplacian::FapplyT (int amrlev, int mglev, MF& out, const MF& in) const
+{
 
     const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
     AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
@@ -302,6 +339,21 @@ void
 MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs, int redblack) const
 {
     BL_PROFILE("MLABecLaplacian::Fsmooth()");
+    FsmoothT(amrlev, mglev, sol, rhs, redblack);
+}
+
+void
+MLABecLaplacian::FsmoothSP (int amrlev, int mglev, FloatMultiFab& sol, const FloatMultiFab& rhs,
+                            int redblack) const
+{
+    BL_PROFILE("MLABecLaplacian::FsmoothSP()");
+    FsmoothT(amrlev, mglev, sol, rhs, redblack);
+}
+
+template <typename MF>
+void
+MLABecLaplacian::FsmoothT (int amrlev, int mglev, MF& sol, const MF& rhs, int redblack) const
+{
 
     const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
     AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
@@ -395,6 +447,200 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
     }
 }
 
+void
+MLABecLaplacian::fillDeepCoeffs (int amrlev, int mglev) const
+{
+    const Geometry& geom = m_geom[amrlev][mglev];
+    const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
+    MultiFab::Copy(*m_a_coeffs_deep[mglev], acoef, 0, 0, acoef.nComp(), 0);
+    m_a_coeffs_deep[mglev]->FillBoundary(geom.periodicity());
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        const MultiFab& bcoef = m_b_coeffs[amrlev][mglev][idim];
+        MultiFab::Copy(*m_b_coeffs_deep[mglev][idim], bcoef, 0, 0, bcoef.nComp(), 0);
+        m_b_coeffs_deep[mglev][idim]->FillBoundary(geom.periodicity());
+    }
+}
+
+void
+MLABecLaplacian::FsmoothDeep (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                              int redblack, int ngrow) const
+{
+    BL_PROFILE("MLABecLaplacian::FsmoothDeep()");
+
+    const Geometry& geom = m_geom[amrlev][mglev];
+
+    // Coefficients for the largest region sol allows, built on first use.
+    const int ngc = sol.nGrow();
+    if (m_a_coeffs_deep.empty()) {
+        m_a_coeffs_deep.resize(m_num_mg_levels[amrlev]);
+        m_b_coeffs_deep.resize(m_num_mg_levels[amrlev]);
+    }
+    if (m_a_coeffs_deep[mglev] == nullptr || m_a_coeffs_deep[mglev]->nGrow() < ngc)
+    {
+        const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
+        m_a_coeffs_deep[mglev].reset(new MultiFab(acoef.boxArray(), acoef.DistributionMap(),
+                                                  acoef.nComp(), ngc, MFInfo(),
+                                                  *m_factory[amrlev][mglev]));
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const MultiFab& bcoef = m_b_coeffs[amrlev][mglev][idim];
+            m_b_coeffs_deep[mglev][idim].reset(new MultiFab(bcoef.boxArray(), bcoef.DistributionMap(),
+                                                            bcoef.nComp(), ngc, MFInfo(),
+                                                            *m_factory[amrlev][mglev]));
+        }
+        fillDeepCoeffs(amrlev, mglev);
+    }
+
+    const MultiFab& acoef = *m_a_coeffs_deep[mglev];
+    AMREX_D_TERM(const MultiFab& bxcoef = *m_b_coeffs_deep[mglev][0];,
+                 const MultiFab& bycoef = *m_b_coeffs_deep[mglev][1];,
+                 const MultiFab& bzcoef = *m_b_coeffs_deep[mglev][2];);
+
+    const Box& domain = geom.Domain();
+    const Box& gdomain = geom.growPeriodicDomain(ngrow);
+
+    GpuArray<Real,AMREX_SPACEDIM> flo, fhi;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        if (geom.isPeriodic(idim)) {
+            flo[idim] = 0.0;
+            fhi[idim] = 0.0;
+        } else {
+            int nx;
+            GpuArray<Real,4> coef;
+            deepGhostBC(amrlev, mglev, Orientation(idim,Orientation::low ), nx, coef, flo[idim]);
+            deepGhostBC(amrlev, mglev, Orientation(idim,Orientation::high), nx, coef, fhi[idim]);
+        }
+    }
+
+    const int nc = getNComp();
+    const Real* h = geom.CellSize();
+    AMREX_D_TERM(const Real dhx = m_b_scalar/(h[0]*h[0]);,
+                 const Real dhy = m_b_scalar/(h[1]*h[1]);,
+                 const Real dhz = m_b_scalar/(h[2]*h[2]));
+    const Real alpha = m_a_scalar;
+
+    MFItInfo mfi_info;
+    if (Gpu::notInLaunchRegion()) mfi_info.EnableTiling().SetDynamic(true);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(sol,mfi_info); mfi.isValid(); ++mfi)
+    {
+        const Box& tbx = mfi.growntilebox(ngrow) & gdomain;
+        const auto& solnfab = sol.array(mfi);
+        const auto& rhsfab  = rhs.array(mfi);
+        const auto& afab    = acoef.array(mfi);
+
+        AMREX_D_TERM(const auto& bxfab = bxcoef.array(mfi);,
+                     const auto& byfab = bycoef.array(mfi);,
+                     const auto& bzfab = bzcoef.array(mfi););
+
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
+        {
+            abec_gsrb_deep(thread_box, solnfab, rhsfab, alpha, afab,
+                           AMREX_D_DECL(dhx, dhy, dhz),
+                           AMREX_D_DECL(bxfab, byfab, bzfab),
+                           flo, fhi, domain, redblack, nc);
+        });
+    }
+}
+
+void
+MLABecLaplacian::getDiagonal (int amrlev, int mglev, MultiFab& diag) const
+{
+    BL_PROFILE("MLABecLaplacian::getDiagonal()");
+
+    const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
+    AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
+                 const MultiFab& bycoef = m_b_coeffs[amrlev][mglev][1];,
+                 const MultiFab& bzcoef = m_b_coeffs[amrlev][mglev][2];);
+    const auto& undrrelxr = m_undrrelxr[amrlev][mglev];
+    const auto& maskvals  = m_maskvals [amrlev][mglev];
+
+    OrientationIter oitr;
+
+    const FabSet& f0 = undrrelxr[oitr()]; ++oitr;
+    const FabSet& f1 = undrrelxr[oitr()]; ++oitr;
+#if (AMREX_SPACEDIM > 1)
+    const FabSet& f2 = undrrelxr[oitr()]; ++oitr;
+    const FabSet& f3 = undrrelxr[oitr()]; ++oitr;
+#if (AMREX_SPACEDIM > 2)
+    const FabSet& f4 = undrrelxr[oitr()]; ++oitr;
+    const FabSet& f5 = undrrelxr[oitr()]; ++oitr;
+#endif
+#endif
+
+    const MultiMask& mm0 = maskvals[0];
+    const MultiMask& mm1 = maskvals[1];
+#if (AMREX_SPACEDIM > 1)
+    const MultiMask& mm2 = maskvals[2];
+    const MultiMask& mm3 = maskvals[3];
+#if (AMREX_SPACEDIM > 2)
+    const MultiMask& mm4 = maskvals[4];
+    const MultiMask& mm5 = maskvals[5];
+#endif
+#endif
+
+    const int nc = getNComp();
+    const Real* h = m_geom[amrlev][mglev].CellSize();
+    AMREX_D_TERM(const Real dhx = m_b_scalar/(h[0]*h[0]);,
+                 const Real dhy = m_b_scalar/(h[1]*h[1]);,
+                 const Real dhz = m_b_scalar/(h[2]*h[2]));
+    const Real alpha = m_a_scalar;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(diag,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const auto& m0 = mm0.array(mfi);
+        const auto& m1 = mm1.array(mfi);
+#if (AMREX_SPACEDIM > 1)
+        const auto& m2 = mm2.array(mfi);
+        const auto& m3 = mm3.array(mfi);
+#if (AMREX_SPACEDIM > 2)
+        const auto& m4 = mm4.array(mfi);
+        const auto& m5 = mm5.array(mfi);
+#endif
+#endif
+
+        const Box& tbx = mfi.tilebox();
+        const Box& vbx = mfi.validbox();
+        const auto& dfab = diag.array(mfi);
+        const auto& afab = acoef.array(mfi);
+
+        AMREX_D_TERM(const auto& bxfab = bxcoef.array(mfi);,
+                     const auto& byfab = bycoef.array(mfi);,
+                     const auto& bzfab = bzcoef.array(mfi););
+
+        const auto& f0fab = f0.array(mfi);
+        const auto& f1fab = f1.array(mfi);
+#if (AMREX_SPACEDIM > 1)
+        const auto& f2fab = f2.array(mfi);
+        const auto& f3fab = f3.array(mfi);
+#if (AMREX_SPACEDIM > 2)
+        const auto& f4fab = f4.array(mfi);
+        const auto& f5fab = f5.array(mfi);
+#endif
+#endif
+
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
+        {
+            abec_diag(thread_box, dfab, alpha, afab,
+                      AMREX_D_DECL(dhx, dhy, dhz),
+                      AMREX_D_DECL(bxfab, byfab, bzfab),
+                      AMREX_D_DECL(m0,m2,m4),
+                      AMREX_D_DECL(m1,m3,m5),
+                      AMREX_D_DECL(f0fab,f2fab,f4fab),
+                      AMREX_D_DECL(f1fab,f3fab,f5fab),
+                      vbx, nc);
+        });
+    }
+}
+
 void
 MLABecLaplacian::FFlux (int amrlev, const MFIter& mfi,
                         const Array<FArrayBox*,AMREX_SPACEDIM>& flux,
@@ -487,14 +733,30 @@ MLABecLaplacian::update ()
 {
     if (MLCellABecLap::needsUpdate()) MLCellABecLap::update();
 
+    updateCoeffs();
+}
+
+// Re-averages the coefficients of the AMR levels that have changed since
+// the last call, and refreshes what depends on them.  Everything is updated
+// in place so that no memory is allocated after the first solve.
+void
+MLABecLaplacian::updateCoeffs ()
+{
 #if (AMREX_SPACEDIM != 3)
     applyMetricTermsCoeffs();
 #endif
 
     averageDownCoeffs();
+    clearChebyshevData();
+    if (m_coeffs_changed[0]) {
+        for (int mglev = 0; mglev < m_a_coeffs_deep.size(); ++mglev) {
+            if (m_a_coeffs_deep[mglev]) fillDeepCoeffs(0, mglev);
+        }
+    }
+    std::fill(m_coeffs_changed.begin(), m_coeffs_changed.end(), 0);
 
-    m_is_singular.clear();
-    m_is_singular.resize(m_num_amr_levels, false);
+    m_is_singular.resize(m_num_amr_levels);
+    std::fill(m_is_singular.begin(), m_is_singular.end(), false);
     auto itlo = std::find(m_lobc[0].begin(), m_lobc[0].end(), BCType::Dirichlet);
     auto ithi = std::find(m_hibc[0].begin(), m_hibc[0].end(), BCType::Dirichlet);
     if (itlo == m_lobc[0].end() && ithi == m_hibc[0].end())
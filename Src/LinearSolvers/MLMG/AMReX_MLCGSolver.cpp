@@ -48,6 +48,56 @@ sxay (MultiFab&       ss,
     sxay(ss,xx,a,yy,0,nghost);
 }
 
+//
+// Global sums and maxima of a few local values, e.g., the local parts of
+// dot products and norms, that are started by start and completed by wait.
+// The results replace the local values in place.
+//
+class NonBlockingReduce
+{
+public:
+
+    explicit NonBlockingReduce (MPI_Comm comm) : m_comm(comm) {}
+    ~NonBlockingReduce () { wait(); }
+
+    NonBlockingReduce (const NonBlockingReduce&) = delete;
+    NonBlockingReduce& operator= (const NonBlockingReduce&) = delete;
+
+    void start (Real* sums, int nsums, Real* maxs, int nmaxs)
+    {
+#ifdef BL_USE_MPI
+        BL_ASSERT(m_nreqs == 0);
+        if (nsums > 0) {
+            MPI_Iallreduce(MPI_IN_PLACE, sums, nsums, ParallelDescriptor::Mpi_typemap<Real>::type(),
+                           MPI_SUM, m_comm, &m_reqs[m_nreqs++]);
+        }
+        if (nmaxs > 0) {
+            MPI_Iallreduce(MPI_IN_PLACE, maxs, nmaxs, ParallelDescriptor::Mpi_typemap<Real>::type(),
+                           MPI_MAX, m_comm, &m_reqs[m_nreqs++]);
+        }
+#endif
+    }
+
+    void wait ()
+    {
+#ifdef BL_USE_MPI
+        if (m_nreqs > 0) {
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            MPI_Waitall(m_nreqs, m_reqs, MPI_STATUSES_IGNORE);
+            m_nreqs = 0;
+        }
+#endif
+    }
+
+private:
+
+    MPI_Comm m_comm;
+#ifdef BL_USE_MPI
+    MPI_Request m_reqs[2];
+    int m_nreqs = 0;
+#endif
+};
+
 }
 
 MLCGSolver::MLCGSolver (MLMG* a_mlmg, MLLinOp& _lp, Type _typ)
@@ -63,16 +113,43 @@ MLCGSolver::~MLCGSolver ()
 {
 }
 
+// The i-th temporary of a solve.  It is only reallocated if the workspace
+// does not have a matching one.
+MultiFab&
+MLCGSolver::makeTemp (int i, const BoxArray& ba, const DistributionMapping& dm,
+                      int ncomp, int ng, const FabFactory<FArrayBox>& factory)
+{
+    auto& temps = (workspace) ? *workspace : m_temps;
+    if (temps.size() <= i) temps.resize(i+1);
+    auto& mf = temps[i];
+    if (mf == nullptr || mf->nComp() != ncomp || mf->nGrow() != ng ||
+        mf->boxArray() != ba || mf->DistributionMap() != dm)
+    {
+        mf.reset(new MultiFab(ba, dm, ncomp, ng, MFInfo(), factory));
+    }
+    return *mf;
+}
+
 int
 MLCGSolver::solve (MultiFab&       sol,
                    const MultiFab& rhs,
                    Real            eps_rel,
                    Real            eps_abs)
 {
-    if (solver_type == Type::BiCGStab) {
+    nreductions = 0;
+
+    switch (solver_type)
+    {
+    case Type::BiCGStab:
         return solve_bicgstab(sol,rhs,eps_rel,eps_abs);
-    } else {
+    case Type::CG:
         return solve_cg(sol,rhs,eps_rel,eps_abs);
+    case Type::PipelinedBiCGStab:
+        return solve_pipelined_bicgstab(sol,rhs,eps_rel,eps_abs);
+    case Type::PipelinedCG:
+        return solve_pipelined_cg(sol,rhs,eps_rel,eps_abs);
+    default:
+        return solve_sstep_cg(sol,rhs,eps_rel,eps_abs);
     }
 }
 
@@ -90,18 +167,18 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
     const DistributionMapping& dm = sol.DistributionMap();
     const auto& factory = sol.Factory();
 
-    MultiFab ph(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
-    MultiFab sh(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    MultiFab& ph = makeTemp(0, ba, dm, ncomp, sol.nGrow(), factory);
+    MultiFab& sh = makeTemp(1, ba, dm, ncomp, sol.nGrow(), factory);
     ph.setVal(0.0);
     sh.setVal(0.0);
 
-    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
-    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
-    MultiFab r    (ba, dm, ncomp, nghost, MFInfo(), factory);
-    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
-    MultiFab rh   (ba, dm, ncomp, nghost, MFInfo(), factory);
-    MultiFab v    (ba, dm, ncomp, nghost, MFInfo(), factory);
-    MultiFab t    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab& sorig = makeTemp(2, ba, dm, ncomp, nghost, factory);
+    MultiFab& p     = makeTemp(3, ba, dm, ncomp, nghost, factory);
+    MultiFab& r     = makeTemp(4, ba, dm, ncomp, nghost, factory);
+    MultiFab& s     = makeTemp(5, ba, dm, ncomp, nghost, factory);
+    MultiFab& rh    = makeTemp(6, ba, dm, ncomp, nghost, factory);
+    MultiFab& v     = makeTemp(7, ba, dm, ncomp, nghost, factory);
+    MultiFab& t     = makeTemp(8, ba, dm, ncomp, nghost, factory);
 
     Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
 
@@ -198,6 +275,7 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
         BL_PROFILE_VAR("MLCGSolver::ParallelAllReduce", blp_par);
         ParallelAllReduce::Sum(tvals,2,Lp.BottomCommunicator());
         BL_PROFILE_VAR_STOP(blp_par);
+        ++nreductions;
 
         if ( tvals[0] )
 	{
@@ -273,13 +351,13 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     const DistributionMapping& dm = sol.DistributionMap();
     const auto& factory = sol.Factory();
 
-    MultiFab p(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    MultiFab& p = makeTemp(0, ba, dm, ncomp, sol.nGrow(), factory);
     p.setVal(0.0);
 
-    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
-    MultiFab r    (ba, dm, ncomp, nghost, MFInfo(), factory);
-    MultiFab z    (ba, dm, ncomp, nghost, MFInfo(), factory);
-    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab& sorig = makeTemp(1, ba, dm, ncomp, nghost, factory);
+    MultiFab& r     = makeTemp(2, ba, dm, ncomp, nghost, factory);
+    MultiFab& z     = makeTemp(3, ba, dm, ncomp, nghost, factory);
+    MultiFab& q     = makeTemp(4, ba, dm, ncomp, nghost, factory);
 
     MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
 
@@ -392,13 +470,632 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     return ret;
 }
 
+int
+MLCGSolver::solve_pipelined_bicgstab (MultiFab&       sol,
+                                      const MultiFab& rhs,
+                                      Real            eps_rel,
+                                      Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipelined_bicgstab");
+
+    //
+    // Pipelined BiCGStab of Cools and Vanroose.  The two global reductions
+    // of each iteration are nonblocking and overlap with the two
+    // applications of the operator.  In addition to the vectors of
+    // BiCGStab, it keeps s = A p, z = A s, w = A r, t = A w and v = A z.
+    //
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // These are the inputs of apply and need ghost cells.
+    MultiFab& r = makeTemp(0, ba, dm, ncomp, sol.nGrow(), factory);
+    MultiFab& w = makeTemp(1, ba, dm, ncomp, sol.nGrow(), factory);
+    MultiFab& z = makeTemp(2, ba, dm, ncomp, sol.nGrow(), factory);
+    r.setVal(0.0);
+    w.setVal(0.0);
+    z.setVal(0.0);
+
+    MultiFab& sorig = makeTemp(3, ba, dm, ncomp, nghost, factory);
+    MultiFab& rh    = makeTemp(4, ba, dm, ncomp, nghost, factory);
+    MultiFab& p     = makeTemp(5, ba, dm, ncomp, nghost, factory);
+    MultiFab& s     = makeTemp(6, ba, dm, ncomp, nghost, factory);
+    MultiFab& t     = makeTemp(7, ba, dm, ncomp, nghost, factory);
+    MultiFab& v     = makeTemp(8, ba, dm, ncomp, nghost, factory);
+    MultiFab& q     = makeTemp(9, ba, dm, ncomp, nghost, factory);
+    MultiFab& y     = makeTemp(10, ba, dm, ncomp, nghost, factory);
+
+    auto apply = [&] (MultiFab& out, MultiFab& in)
+    {
+        Lp.apply(amrlev, mglev, out, in, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, out);
+    };
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+    Lp.normalize(amrlev, mglev, r);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+    MultiFab::Copy(rh,   r,  0,0,ncomp,nghost);
+
+    sol.setVal(0);
+
+    NonBlockingReduce reduce(Lp.BottomCommunicator());
+
+    apply(w, r);
+
+    Real dots[4] = { dotxy(rh,r,true), dotxy(rh,w,true) };
+    Real rnorm = norm_inf(r,true);
+    reduce.start(dots, 2, &rnorm, 1);
+    apply(t, w);
+    reduce.wait();
+    ++nreductions;
+
+    const Real rnorm0 = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Initial error (error0) =        " << rnorm0 << '\n';
+    }
+    int ret = 0;
+    iter = 1;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedBiCGStab: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        sol.plus(sorig, 0, ncomp, nghost);
+        return ret;
+    }
+
+    Real rho = dots[0];
+    Real alpha = 0, beta = 0, omega = 0;
+    if ( dots[1] != 0 )
+    {
+        alpha = rho/dots[1];
+    }
+    else
+    {
+        ret = 2;
+    }
+
+    for (; ret == 0 && iter <= maxiter; ++iter)
+    {
+        if ( rho == 0 )
+        {
+            ret = 1; break;
+        }
+        if ( iter == 1 )
+        {
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(z,t,0,0,ncomp,nghost);
+        }
+        else
+        {
+            sxay(p, p, -omega, s, nghost);
+            sxay(p, r,   beta, p, nghost);
+            sxay(s, s, -omega, z, nghost);
+            sxay(s, w,   beta, s, nghost);
+            sxay(z, z, -omega, v, nghost);
+            sxay(z, t,   beta, z, nghost);
+        }
+        sxay(q, r, -alpha, s, nghost);
+        sxay(y, w, -alpha, z, nghost);
+
+        dots[0] = dotxy(q,y,true);
+        dots[1] = dotxy(y,y,true);
+        rnorm = norm_inf(q,true);
+        reduce.start(dots, 2, &rnorm, 1);
+        apply(v, z);
+        reduce.wait();
+        ++nreductions;
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Half Iter "
+                           << std::setw(11) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+        {
+            sxay(sol, sol, alpha, p, nghost);
+            break;
+        }
+
+        if ( dots[1] != 0 )
+        {
+            omega = dots[0]/dots[1];
+        }
+        else
+        {
+            ret = 3; break;
+        }
+
+        sxay(sol, sol, alpha, p, nghost);
+        sxay(sol, sol, omega, q, nghost);
+        sxay(r,     q, -omega, y, nghost);
+        sxay(t,     t, -alpha, v, nghost);
+        sxay(w,     y, -omega, t, nghost);
+
+        dots[0] = dotxy(rh,r,true);
+        dots[1] = dotxy(rh,w,true);
+        dots[2] = dotxy(rh,s,true);
+        dots[3] = dotxy(rh,z,true);
+        rnorm = norm_inf(r,true);
+        reduce.start(dots, 4, &rnorm, 1);
+        apply(t, w);
+        reduce.wait();
+        ++nreductions;
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Iteration "
+                           << std::setw(11) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+
+        if ( omega == 0 )
+        {
+            ret = 4; break;
+        }
+
+        beta = (alpha/omega)*(dots[0]/rho);
+        rho = dots[0];
+        if ( Real den = dots[1] + beta*dots[2] - beta*omega*dots[3] )
+        {
+            alpha = rho/den;
+        }
+        else
+        {
+            ret = 2; break;
+        }
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Final: Iteration "
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipelinedBiCGStab:: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
+int
+MLCGSolver::solve_pipelined_cg (MultiFab&       sol,
+                                const MultiFab& rhs,
+                                Real            eps_rel,
+                                Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipelined_cg");
+
+    //
+    // Pipelined CG of Ghysels and Vanroose.  The one global reduction of
+    // each iteration is nonblocking and overlaps with the application of
+    // the operator.  In addition to the vectors of CG, it keeps s = A p,
+    // z = A s and w = A r.
+    //
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // These are the inputs of apply and need ghost cells.
+    MultiFab& r = makeTemp(0, ba, dm, ncomp, sol.nGrow(), factory);
+    MultiFab& w = makeTemp(1, ba, dm, ncomp, sol.nGrow(), factory);
+    r.setVal(0.0);
+    w.setVal(0.0);
+
+    MultiFab& sorig = makeTemp(2, ba, dm, ncomp, nghost, factory);
+    MultiFab& p     = makeTemp(3, ba, dm, ncomp, nghost, factory);
+    MultiFab& s     = makeTemp(4, ba, dm, ncomp, nghost, factory);
+    MultiFab& z     = makeTemp(5, ba, dm, ncomp, nghost, factory);
+    MultiFab& q     = makeTemp(6, ba, dm, ncomp, nghost, factory);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    sol.setVal(0);
+
+    Lp.apply(amrlev, mglev, w, r, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+    NonBlockingReduce reduce(Lp.BottomCommunicator());
+
+    Real rnorm  = 0;
+    Real rnorm0 = 0;
+    Real gamma_1 = 0, alpha_1 = 0;
+    int  ret = 0;
+
+    for (iter = 0; ; ++iter)
+    {
+        // r is the residual after iter iterations and w = A r
+        Real dots[2] = { dotxy(r,r,true), dotxy(w,r,true) };
+        rnorm = norm_inf(r,true);
+        reduce.start(dots, 2, &rnorm, 1);
+        Lp.apply(amrlev, mglev, q, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        reduce.wait();
+        ++nreductions;
+
+        if ( iter == 0 )
+        {
+            rnorm0 = rnorm;
+
+            if ( verbose > 0 )
+            {
+                amrex::Print() << "MLCGSolver_PipelinedCG: Initial error (error0) :        " << rnorm0 << '\n';
+            }
+
+            if ( rnorm0 == 0 || rnorm0 < eps_abs )
+            {
+                if ( verbose > 0 ) {
+                    amrex::Print() << "MLCGSolver_PipelinedCG: niter = 0,"
+                                   << ", rnorm = " << rnorm
+                                   << ", eps_abs = " << eps_abs << std::endl;
+                }
+                sol.plus(sorig, 0, ncomp, nghost);
+                return ret;
+            }
+        }
+        else
+        {
+            if ( verbose > 2 )
+            {
+                amrex::Print() << "MLCGSolver_PipelinedCG:       Iteration"
+                               << std::setw(4) << iter
+                               << " rel. err. "
+                               << rnorm/(rnorm0) << '\n';
+            }
+
+            if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+        }
+
+        if ( iter == maxiter ) break;
+
+        const Real gamma = dots[0];
+        const Real delta = dots[1];
+
+        if ( gamma == 0 )
+        {
+            ret = 1; break;
+        }
+
+        Real alpha, beta;
+        if ( iter == 0 )
+        {
+            beta = 0;
+            if ( delta == 0 )
+            {
+                ret = 1; break;
+            }
+            alpha = gamma/delta;
+
+            MultiFab::Copy(z,q,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+        }
+        else
+        {
+            beta = gamma/gamma_1;
+            if ( Real den = delta - beta*gamma/alpha_1 )
+            {
+                alpha = gamma/den;
+            }
+            else
+            {
+                ret = 1; break;
+            }
+
+            sxay(z, q, beta, z, nghost);
+            sxay(s, w, beta, s, nghost);
+            sxay(p, r, beta, p, nghost);
+        }
+
+        sxay(sol, sol,  alpha, p, nghost);
+        sxay(  r,   r, -alpha, s, nghost);
+        sxay(  w,   w, -alpha, z, nghost);
+
+        gamma_1 = gamma;
+        alpha_1 = alpha;
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipelinedCG: Final Iteration"
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 &&  rnorm > eps_rel*rnorm0 && rnorm > eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipelinedCG: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
+int
+MLCGSolver::solve_sstep_cg (MultiFab&       sol,
+                            const MultiFab& rhs,
+                            Real            eps_rel,
+                            Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::sstep_cg");
+
+    //
+    // s-step CG.  Each outer iteration builds the basis
+    //
+    //   Y = [p, A p, ..., A^s p, r, A r, ..., A^{s-1} r]
+    //
+    // (scaled by powers of an estimate of the norm of A), computes all the
+    // dot products G = Y^T Y in one global reduction, does s iterations of
+    // CG on the coordinates in this basis, and then recovers x, r and p.
+    // This costs 2s-1 applications of the operator per s iterations and is
+    // exact in exact arithmetic, but the basis becomes ill-conditioned as
+    // s grows.  s between 2 and 5 is reasonable.
+    //
+    const int ss = std::max(1, sstep);
+    const int m = 2*ss + 1;
+    const int ir = ss + 1;  // index of r in the basis
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    Vector<MultiFab*> Y(m);
+    for (int i = 0; i < m; ++i) {
+        Y[i] = &makeTemp(i+3, ba, dm, ncomp, sol.nGrow(), factory);
+        Y[i]->setVal(0.0);
+    }
+    MultiFab& p = *Y[0];
+    MultiFab& r = *Y[ir];
+
+    MultiFab& sorig = makeTemp(0, ba, dm, ncomp, nghost, factory);
+    MultiFab& pnew  = makeTemp(1, ba, dm, ncomp, nghost, factory);
+    MultiFab& rnew  = makeTemp(2, ba, dm, ncomp, nghost, factory);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    sol.setVal(0);
+
+    MultiFab::Copy(p,r,0,0,ncomp,nghost);
+
+    NonBlockingReduce reduce(Lp.BottomCommunicator());
+
+    // Scale of the basis: |A r|/|r|
+    Lp.apply(amrlev, mglev, *Y[1], p, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+    Real tvals[2] = { dotxy(r,r,true), dotxy(*Y[1],*Y[1],true) };
+    Real rnorm = norm_inf(r,true);
+    reduce.start(tvals, 2, &rnorm, 1);
+    reduce.wait();
+    ++nreductions;
+
+    const Real rnorm0 = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_SStepCG: Initial error (error0) :        " << rnorm0 << '\n';
+    }
+
+    int ret = 0;
+    iter = 0;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 ) {
+            amrex::Print() << "MLCGSolver_SStepCG: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        sol.plus(sorig, 0, ncomp, nghost);
+        return ret;
+    }
+
+    const Real theta = (tvals[0] > 0 && tvals[1] > 0) ? std::sqrt(tvals[1]/tvals[0]) : 1.0;
+
+    Vector<Real> G(m*m), B(m*m, 0.0);
+    for (int j = 0; j < ss; ++j) {
+        B[(j+1)*m + j] = theta;
+    }
+    for (int j = 0; j < ss-1; ++j) {
+        B[(ir+j+1)*m + ir+j] = theta;
+    }
+
+    auto matvec = [m] (const Vector<Real>& M, const Vector<Real>& a, Vector<Real>& b)
+    {
+        for (int i = 0; i < m; ++i) {
+            b[i] = 0.0;
+            for (int j = 0; j < m; ++j) {
+                b[i] += M[i*m+j]*a[j];
+            }
+        }
+    };
+    auto gdot = [m, &G] (const Vector<Real>& a, const Vector<Real>& b)
+    {
+        Real result = 0.0;
+        for (int i = 0; i < m; ++i) {
+            for (int j = 0; j < m; ++j) {
+                result += a[i]*G[i*m+j]*b[j];
+            }
+        }
+        return result;
+    };
+
+    Vector<Real> xc(m), rc(m), pc(m), Bp(m), rc_new(m);
+
+    bool first = true;
+    while (true)
+    {
+        // The basis.  A p is already in Y[1] in the first outer iteration.
+        for (int j = 0; j < ss; ++j) {
+            if (!first || j > 0) {
+                Lp.apply(amrlev, mglev, *Y[j+1], *Y[j], MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+            }
+            Y[j+1]->mult(1.0/theta, 0, ncomp, nghost);
+        }
+        first = false;
+        for (int j = 0; j < ss-1; ++j) {
+            Lp.apply(amrlev, mglev, *Y[ir+j+1], *Y[ir+j], MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+            Y[ir+j+1]->mult(1.0/theta, 0, ncomp, nghost);
+        }
+
+        for (int i = 0; i < m; ++i) {
+            for (int j = i; j < m; ++j) {
+                G[i*m+j] = dotxy(*Y[i],*Y[j],true);
+            }
+        }
+        Vector<Real> gpacked;
+        gpacked.reserve(m*(m+1)/2);
+        for (int i = 0; i < m; ++i) {
+            for (int j = i; j < m; ++j) {
+                gpacked.push_back(G[i*m+j]);
+            }
+        }
+        rnorm = norm_inf(r,true);
+        reduce.start(gpacked.data(), gpacked.size(), &rnorm, 1);
+        reduce.wait();
+        ++nreductions;
+        for (int i = 0, k = 0; i < m; ++i) {
+            for (int j = i; j < m; ++j, ++k) {
+                G[i*m+j] = G[j*m+i] = gpacked[k];
+            }
+        }
+
+        if ( verbose > 2 && iter > 0 )
+        {
+            amrex::Print() << "MLCGSolver_SStepCG:       Iteration"
+                           << std::setw(4) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+        if ( iter >= maxiter ) break;
+
+        std::fill(xc.begin(), xc.end(), 0.0);
+        std::fill(rc.begin(), rc.end(), 0.0);
+        std::fill(pc.begin(), pc.end(), 0.0);
+        rc[ir] = 1.0;
+        pc[0] = 1.0;
+
+        Real rr = gdot(rc,rc);
+        for (int j = 0; j < ss && iter < maxiter; ++j, ++iter)
+        {
+            matvec(B, pc, Bp);
+            const Real pAp = gdot(pc,Bp);
+            if ( rr <= 0 || pAp <= 0 )
+            {
+                ret = 1; break;
+            }
+            const Real alpha = rr/pAp;
+            for (int i = 0; i < m; ++i) {
+                xc[i] += alpha*pc[i];
+                rc_new[i] = rc[i] - alpha*Bp[i];
+            }
+            const Real rr_new = gdot(rc_new,rc_new);
+            const Real beta = rr_new/rr;
+            for (int i = 0; i < m; ++i) {
+                pc[i] = rc_new[i] + beta*pc[i];
+            }
+            std::swap(rc, rc_new);
+            rr = rr_new;
+        }
+
+        if (ret != 0) break;
+
+        pnew.setVal(0.0, 0, ncomp, nghost);
+        rnew.setVal(0.0, 0, ncomp, nghost);
+        for (int i = 0; i < m; ++i) {
+            if (xc[i] != 0) MultiFab::Saxpy(sol,  xc[i], *Y[i], 0, 0, ncomp, nghost);
+            if (rc[i] != 0) MultiFab::Saxpy(rnew, rc[i], *Y[i], 0, 0, ncomp, nghost);
+            if (pc[i] != 0) MultiFab::Saxpy(pnew, pc[i], *Y[i], 0, 0, ncomp, nghost);
+        }
+        MultiFab::Copy(r,rnew,0,0,ncomp,nghost);
+        MultiFab::Copy(p,pnew,0,0,ncomp,nghost);
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_SStepCG: Final Iteration"
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 &&  rnorm > eps_rel*rnorm0 && rnorm > eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_SStepCG: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
 Real
 MLCGSolver::dotxy (const MultiFab& r, const MultiFab& z, bool local)
 {
     BL_PROFILE_VAR_NS("MLCGSolver::ParallelAllReduce", blp_par);
     if (!local) { BL_PROFILE_VAR_START(blp_par); }
     Real result = Lp.xdoty(amrlev, mglev, r, z, local);
-    if (!local) { BL_PROFILE_VAR_STOP(blp_par); }
+    if (!local) { BL_PROFILE_VAR_STOP(blp_par); ++nreductions; }
     return result;
 }
 
@@ -413,6 +1110,7 @@ MLCGSolver::norm_inf (const MultiFab& res, bool local)
     if (!local) {
         BL_PROFILE("MLCGSolver::ParallelAllReduce");
         ParallelAllReduce::Max(result, Lp.BottomCommunicator());
+        ++nreductions;
     }
     return result;
 }
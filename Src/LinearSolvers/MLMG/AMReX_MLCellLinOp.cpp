@@ -278,13 +278,34 @@ MLCellLinOp::makeNGrids (int grid_size) const
 }
 
 void
-MLCellLinOp::restriction (int, int, MultiFab& crse, MultiFab& fine) const
+MLCellLinOp::restriction (int amrlev, int cmglev, MultiFab& crse, MultiFab& fine) const
 {
     const int ncomp = getNComp();
 #ifdef AMREX_SOFT_PERF_COUNTERS
     perf_counters.restrict(crse);
 #endif
-    amrex::average_down(fine, crse, 0, ncomp, 2);
+    if (amrex::isMFIterSafe(crse, fine))
+    {
+        amrex::average_down(fine, crse, 0, ncomp, 2);
+    }
+    else
+    {
+        // crse has been agglomerated.  The temporary on the coarsened
+        // BoxArray of fine is kept for the next call.
+        if (m_restriction_cfine.empty()) {
+            m_restriction_cfine.resize(m_num_amr_levels);
+            for (int alev = 0; alev < m_num_amr_levels; ++alev) {
+                m_restriction_cfine[alev].resize(m_num_mg_levels[alev]);
+            }
+        }
+        auto& cfine = m_restriction_cfine[amrlev][cmglev];
+        if (cfine == nullptr) {
+            cfine.reset(new MultiFab(amrex::coarsen(fine.boxArray(), 2), fine.DistributionMap(),
+                                     ncomp, 0));
+        }
+        amrex::average_down(fine, *cfine, 0, ncomp, 2);
+        crse.ParallelCopy(*cfine, 0, 0, ncomp);
+    }
 }
 
 void
@@ -320,8 +341,24 @@ MLCellLinOp::averageDownSolutionRHS (int camrlev, MultiFab& crse_sol, MultiFab&
 {
     const auto amrrr = AMRRefRatio(camrlev);
     const int ncomp = getNComp();
-    amrex::average_down(fine_sol, crse_sol, 0, ncomp, amrrr);
-    amrex::average_down(fine_rhs, crse_rhs, 0, ncomp, amrrr);
+    // The temporary on the coarsened BoxArray of the fine AMR level is kept
+    // for the next call.  It lives in the slot of MG level 0, which
+    // restriction never uses.
+    if (m_restriction_cfine.empty()) {
+        m_restriction_cfine.resize(m_num_amr_levels);
+        for (int alev = 0; alev < m_num_amr_levels; ++alev) {
+            m_restriction_cfine[alev].resize(m_num_mg_levels[alev]);
+        }
+    }
+    auto& cfine = m_restriction_cfine[camrlev+1][0];
+    if (cfine == nullptr) {
+        cfine.reset(new MultiFab(amrex::coarsen(fine_sol.boxArray(), amrrr),
+                                 fine_sol.DistributionMap(), ncomp, 0));
+    }
+    amrex::average_down(fine_sol, *cfine, 0, ncomp, amrrr);
+    crse_sol.ParallelCopy(*cfine, 0, 0, ncomp);
+    amrex::average_down(fine_rhs, *cfine, 0, ncomp, amrrr);
+    crse_rhs.ParallelCopy(*cfine, 0, 0, ncomp);
 }
 
 void
@@ -341,6 +378,10 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
                      bool skip_fillboundary) const
 {
     BL_PROFILE("MLCellLinOp::smooth()");
+    if (info.smoother == Smoother::chebyshev) {
+        chebyshevSmooth(amrlev, mglev, sol, rhs);
+        return;
+    }
     for (int redblack = 0; redblack < 2; ++redblack)
     {
         applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution,
@@ -353,6 +394,149 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
     }
 }
 
+void
+MLCellLinOp::multiSweepSmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                               int nsweeps, bool skip_fillboundary) const
+{
+    const int ngmax = std::min(sol.nGrow(), rhs.nGrow());
+    if (ngmax < 2 || info.smoother == Smoother::chebyshev
+        || !supportsDeepGhostSmooth(amrlev, mglev))
+    {
+        MLLinOp::multiSweepSmooth(amrlev, mglev, sol, rhs, nsweeps, skip_fillboundary);
+        return;
+    }
+
+    BL_PROFILE("MLCellLinOp::multiSweepSmooth()");
+
+    // The ghost cells of rhs must have been filled by the caller.  The
+    // corners are needed too, because the region is grown in all directions.
+    const int ncomp = getNComp();
+    int redblack = 0;
+    for (int nhalf = 2*nsweeps; nhalf > 0; )
+    {
+        const int ng = std::min(ngmax, nhalf);
+        if (!skip_fillboundary) {
+            sol.FillBoundary(0, ncomp, IntVect(ng), m_geom[amrlev][mglev].periodicity());
+            ++m_num_halo_exchanges;
+        }
+        skip_fillboundary = false;
+        for (int ngrow = ng-1; ngrow >= 0; --ngrow)
+        {
+            applyDomainBCDeep(amrlev, mglev, sol, ngrow);
+#ifdef AMREX_SOFT_PERF_COUNTERS
+            perf_counters.smooth(sol);
+#endif
+            FsmoothDeep(amrlev, mglev, sol, rhs, redblack, ngrow);
+            redblack = 1-redblack;
+        }
+        nhalf -= ng;
+    }
+}
+
+bool
+MLCellLinOp::deepGhostSmoothable (int amrlev, int mglev) const
+{
+    if (amrlev != 0 || !m_domain_covered[0] || !isCrossStencil() || isTensorOp()
+        || getNComp() != 1 || maxorder > 4)
+    {
+        return false;
+    }
+
+    // Only domain boundaries, and with maxorder <= blen+1 the Dirichlet
+    // interpolation is the same for all boxes.
+    const Geometry& geom = m_geom[amrlev][mglev];
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        if (geom.isPeriodic(idim)) continue;
+        for (const BCType bc : {m_lobc[0][idim], m_hibc[0][idim]}) {
+            if (bc != BCType::Dirichlet && bc != BCType::Neumann && bc != BCType::reflect_odd) {
+                return false;
+            }
+        }
+        const BoxArray& ba = m_grids[amrlev][mglev];
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            if (ba[i].length(idim)+1 < maxorder) return false;
+        }
+    }
+    return true;
+}
+
+void
+MLCellLinOp::deepGhostBC (int amrlev, int mglev, Orientation face, int& nx,
+                          GpuArray<Real,4>& coef, Real& f) const
+{
+    const int idim = face.coordDir();
+    const BCType bc = face.isLow() ? m_lobc[0][idim] : m_hibc[0][idim];
+    for (int m = 0; m < 4; ++m) coef[m] = 0.0;
+    if (bc == BCType::Dirichlet)
+    {
+        const Real bcl = face.isLow() ? m_domain_bloc_lo[idim] : m_domain_bloc_hi[idim];
+        Real x[4], c[4];
+        nx = maxorder;
+        x[0] = -bcl * m_geom[amrlev][mglev].InvCellSize(idim);
+        for (int m = 1; m < nx; ++m) {
+            x[m] = m - 0.5;
+        }
+        poly_interp_coeff(-0.5, x, nx, c);
+        for (int m = 0; m < nx; ++m) coef[m] = c[m];
+        f = coef[1];
+    }
+    else
+    {
+        // Same as mllinop_comp_interp_coef0_*, which uses 1 for reflect_odd too.
+        nx = 2;
+        coef[1] = (bc == BCType::reflect_odd) ? -1.0 : 1.0;
+        f = 1.0;
+    }
+}
+
+void
+MLCellLinOp::applyDomainBCDeep (int amrlev, int mglev, MultiFab& sol, int ngrow) const
+{
+    const Geometry& geom = m_geom[amrlev][mglev];
+    const Box& domain = geom.Domain();
+    const Box& gdomain = geom.growPeriodicDomain(ngrow);
+
+    for (OrientationIter oitr; oitr; ++oitr)
+    {
+        const Orientation face = oitr();
+        const int idim = face.coordDir();
+        if (geom.isPeriodic(idim)) continue;
+
+        int nx;
+        GpuArray<Real,4> coef;
+        Real f;
+        deepGhostBC(amrlev, mglev, face, nx, coef, f);
+        Dim3 s{0,0,0};
+        const int sgn = face.isLow() ? 1 : -1;
+        if (idim == 0) {
+            s.x = sgn;
+        } else if (idim == 1) {
+            s.y = sgn;
+        } else {
+            s.z = sgn;
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(sol); mfi.isValid(); ++mfi)
+        {
+            const Box& rbx = amrex::grow(mfi.validbox(), ngrow) & gdomain;
+            if (rbx[face] == domain[face])
+            {
+                const Box& bbx = face.isLow() ? amrex::adjCellLo(rbx, idim)
+                                              : amrex::adjCellHi(rbx, idim);
+                const auto& phi = sol.array(mfi);
+                AMREX_HOST_DEVICE_FOR_3D(bbx, i, j, k,
+                {
+                    mllinop_apply_homog_domain_bc(i, j, k, phi, s, nx, coef);
+                });
+            }
+        }
+    }
+}
+
 void
 MLCellLinOp::updateSolBC (int amrlev, const MultiFab& crse_bcdata) const
 {
@@ -443,6 +627,7 @@ MLCellLinOp::applyBC (int amrlev, int mglev, MultiFab& in, BCMode bc_mode, State
     const int tensorop = isTensorOp();
     if (!skip_fillboundary) {
         in.FillBoundary(0, ncomp, m_geom[amrlev][mglev].periodicity(),cross);
+        ++m_num_halo_exchanges;
     }
 
     int flagbc = bc_mode == BCMode::Inhomogeneous;
@@ -456,7 +641,8 @@ MLCellLinOp::applyBC (int amrlev, int mglev, MultiFab& in, BCMode bc_mode, State
     const auto& maskvals = m_maskvals[amrlev][mglev];
     const auto& bcondloc = *m_bcondloc[amrlev][mglev];
 
-    FArrayBox foofab(Box::TheUnitBox(),ncomp);
+    if (m_bc_dummy.nComp() != ncomp) m_bc_dummy.resize(Box::TheUnitBox(), ncomp);
+    FArrayBox& foofab = m_bc_dummy;
     const auto& foo = foofab.array();
 
     MFItInfo mfi_info;
@@ -823,6 +1009,229 @@ MLCellLinOp::prepareForSolve ()
     }
 }
 
+void
+MLCellLinOp::applyBCSP (int amrlev, int mglev, FloatMultiFab& in, bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::applyBCSP()");
+
+    AMREX_ALWAYS_ASSERT(isCrossStencil());
+
+    const int ncomp = getNComp();
+    const int cross = true;
+    if (!skip_fillboundary) {
+        in.FillBoundary(0, ncomp, m_geom[amrlev][mglev].periodicity(), cross);
+        ++m_num_halo_exchanges;
+    }
+
+    const int flagbc = false;
+    const int imaxorder = maxorder;
+
+    const Real dxi = m_geom[amrlev][mglev].InvCellSize(0);
+    const Real dyi = (AMREX_SPACEDIM >= 2) ? m_geom[amrlev][mglev].InvCellSize(1) : 1.0;
+    const Real dzi = (AMREX_SPACEDIM == 3) ? m_geom[amrlev][mglev].InvCellSize(2) : 1.0;
+
+    const auto& maskvals = m_maskvals[amrlev][mglev];
+    const auto& bcondloc = *m_bcondloc[amrlev][mglev];
+
+    if (m_bc_dummy.nComp() != ncomp) m_bc_dummy.resize(Box::TheUnitBox(), ncomp);
+    const FArrayBox& foofab = m_bc_dummy;
+    const auto& foo = foofab.const_array();
+
+    MFItInfo mfi_info;
+    if (Gpu::notInLaunchRegion()) mfi_info.SetDynamic(true);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(in, mfi_info); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx   = mfi.validbox();
+        const auto& iofab = in.array(mfi);
+
+        const auto & bdlv = bcondloc.bndryLocs(mfi);
+        const auto & bdcv = bcondloc.bndryConds(mfi);
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Orientation olo(idim,Orientation::low);
+            const Orientation ohi(idim,Orientation::high);
+            const Box blo = amrex::adjCellLo(vbx, idim);
+            const Box bhi = amrex::adjCellHi(vbx, idim);
+            const int blen = vbx.length(idim);
+            const auto& mlo = maskvals[olo].array(mfi);
+            const auto& mhi = maskvals[ohi].array(mfi);
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                const BoundCond bctlo = bdcv[icomp][olo];
+                const BoundCond bcthi = bdcv[icomp][ohi];
+                const Real bcllo = bdlv[icomp][olo];
+                const Real bclhi = bdlv[icomp][ohi];
+                if (idim == 0) {
+                    AMREX_LAUNCH_HOST_DEVICE_LAMBDA (
+                    blo, tboxlo, {
+                    mllinop_apply_bc_x(0, tboxlo, blen, iofab, mlo,
+                                       bctlo, bcllo, foo,
+                                       imaxorder, dxi, flagbc, icomp);
+                    },
+                    bhi, tboxhi, {
+                    mllinop_apply_bc_x(1, tboxhi, blen, iofab, mhi,
+                                       bcthi, bclhi, foo,
+                                       imaxorder, dxi, flagbc, icomp);
+                    });
+                } else if (idim == 1) {
+                    AMREX_LAUNCH_HOST_DEVICE_LAMBDA (
+                    blo, tboxlo, {
+                    mllinop_apply_bc_y(0, tboxlo, blen, iofab, mlo,
+                                       bctlo, bcllo, foo,
+                                       imaxorder, dyi, flagbc, icomp);
+                    },
+                    bhi, tboxhi, {
+                    mllinop_apply_bc_y(1, tboxhi, blen, iofab, mhi,
+                                       bcthi, bclhi, foo,
+                                       imaxorder, dyi, flagbc, icomp);
+                    });
+                } else {
+                    AMREX_LAUNCH_HOST_DEVICE_LAMBDA (
+                    blo, tboxlo, {
+                    mllinop_apply_bc_z(0, tboxlo, blen, iofab, mlo,
+                                       bctlo, bcllo, foo,
+                                       imaxorder, dzi, flagbc, icomp);
+                    },
+                    bhi, tboxhi, {
+                    mllinop_apply_bc_z(1, tboxhi, blen, iofab, mhi,
+                                       bcthi, bclhi, foo,
+                                       imaxorder, dzi, flagbc, icomp);
+                    });
+                }
+            }
+        }
+    }
+}
+
+void
+MLCellLinOp::restrictionSP (int, int, FloatMultiFab& crse, FloatMultiFab& fine) const
+{
+    BL_PROFILE("MLCellLinOp::restrictionSP()");
+
+    const int ncomp = getNComp();
+
+    BoxArray cba = fine.boxArray();
+    cba.coarsen(2);
+
+    FloatMultiFab cfine;
+    const bool need_parallel_copy = (cba != crse.boxArray() ||
+                                     fine.DistributionMap() != crse.DistributionMap());
+    if (need_parallel_copy) {
+        cfine.define(cba, fine.DistributionMap(), ncomp, 0);
+    }
+    FloatMultiFab& cmf = need_parallel_copy ? cfine : crse;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(cmf,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<float> const& cfab = cmf.array(mfi);
+        Array4<float const> const& ffab = fine.const_array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            const int ii = 2*i;
+#if (AMREX_SPACEDIM == 1)
+            cfab(i,j,k,n) = 0.5f*(ffab(ii,j,k,n) + ffab(ii+1,j,k,n));
+#elif (AMREX_SPACEDIM == 2)
+            const int jj = 2*j;
+            cfab(i,j,k,n) = 0.25f*(ffab(ii,jj  ,k,n) + ffab(ii+1,jj  ,k,n)
+                                 + ffab(ii,jj+1,k,n) + ffab(ii+1,jj+1,k,n));
+#else
+            const int jj = 2*j;
+            const int kk = 2*k;
+            cfab(i,j,k,n) = 0.125f*(ffab(ii,jj  ,kk  ,n) + ffab(ii+1,jj  ,kk  ,n)
+                                  + ffab(ii,jj+1,kk  ,n) + ffab(ii+1,jj+1,kk  ,n)
+                                  + ffab(ii,jj  ,kk+1,n) + ffab(ii+1,jj  ,kk+1,n)
+                                  + ffab(ii,jj+1,kk+1,n) + ffab(ii+1,jj+1,kk+1,n));
+#endif
+        });
+    }
+
+    if (need_parallel_copy) {
+        crse.ParallelCopy(cfine, 0, 0, ncomp);
+    }
+}
+
+void
+MLCellLinOp::interpolationSP (int, int, FloatMultiFab& fine, const FloatMultiFab& crse) const
+{
+    BL_PROFILE("MLCellLinOp::interpolationSP()");
+
+    const int ncomp = getNComp();
+
+    BoxArray cba = fine.boxArray();
+    cba.coarsen(2);
+
+    FloatMultiFab cfine;
+    const FloatMultiFab* cmf = &crse;
+    if (cba != crse.boxArray() || fine.DistributionMap() != crse.DistributionMap()) {
+        cfine.define(cba, fine.DistributionMap(), ncomp, 0);
+        cfine.ParallelCopy(crse, 0, 0, ncomp);
+        cmf = &cfine;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(fine,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx    = mfi.tilebox();
+        Array4<float const> const& cfab = cmf->const_array(mfi);
+        Array4<float> const& ffab = fine.array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            int ic = amrex::coarsen(i,2);
+            int jc = amrex::coarsen(j,2);
+            int kc = amrex::coarsen(k,2);
+            ffab(i,j,k,n) += cfab(ic,jc,kc,n);
+        });
+    }
+}
+
+void
+MLCellLinOp::smoothSP (int amrlev, int mglev, FloatMultiFab& sol, const FloatMultiFab& rhs,
+                       bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::smoothSP()");
+    for (int redblack = 0; redblack < 2; ++redblack)
+    {
+        applyBCSP(amrlev, mglev, sol, skip_fillboundary);
+        FsmoothSP(amrlev, mglev, sol, rhs, redblack);
+        skip_fillboundary = false;
+    }
+}
+
+void
+MLCellLinOp::correctionResidualSP (int amrlev, int mglev, FloatMultiFab& resid, FloatMultiFab& x,
+                                   const FloatMultiFab& b) const
+{
+    BL_PROFILE("MLCellLinOp::correctionResidualSP()");
+    const int ncomp = getNComp();
+
+    applyBCSP(amrlev, mglev, x);
+    FapplySP(amrlev, mglev, resid, x);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(resid,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<float> const& rfab = resid.array(mfi);
+        Array4<float const> const& bfab = b.const_array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            rfab(i,j,k,n) = bfab(i,j,k,n) - rfab(i,j,k,n);
+        });
+    }
+}
+
 Real
 MLCellLinOp::xdoty (int amrlev, int mglev, const MultiFab& x, const MultiFab& y, bool local) const
 {
@@ -475,6 +475,154 @@ MLLinOp::make (Vector<Vector<MultiFab> >& mf, int nc, int ng) const
     }
 }
 
+const MultiFab&
+MLLinOp::chebyshevData (int amrlev, int mglev, Real& lambda_max) const
+{
+    if (m_cheb_dinv.empty()) {
+        m_cheb_dinv.resize(m_num_amr_levels);
+        m_cheb_lambda_max.resize(m_num_amr_levels);
+        m_cheb_work.resize(m_num_amr_levels);
+        for (int alev = 0; alev < m_num_amr_levels; ++alev) {
+            m_cheb_dinv[alev].resize(m_num_mg_levels[alev]);
+            m_cheb_lambda_max[alev].resize(m_num_mg_levels[alev], -1.0);
+            m_cheb_work[alev].resize(m_num_mg_levels[alev]);
+        }
+    }
+
+    // A negative lambda_max means the data are stale, see clearChebyshevData.
+    if (m_cheb_lambda_max[amrlev][mglev] < 0.0)
+    {
+        BL_PROFILE("MLLinOp::chebyshevData()");
+
+        const int ncomp = getNComp();
+        const auto& ba = amrex::convert(m_grids[amrlev][mglev], m_ixtype);
+        const auto& dm = m_dmap[amrlev][mglev];
+        const auto& factory = *m_factory[amrlev][mglev];
+
+        if (m_cheb_dinv[amrlev][mglev] == nullptr) {
+            m_cheb_dinv[amrlev][mglev].reset(new MultiFab(ba, dm, ncomp, 0, MFInfo(), factory));
+            for (auto& w : m_cheb_work[amrlev][mglev]) {
+                w.reset(new MultiFab(ba, dm, ncomp, 0, MFInfo(), factory));
+            }
+        }
+        MultiFab* dinv = m_cheb_dinv[amrlev][mglev].get();
+        getDiagonal(amrlev, mglev, *dinv);
+
+        MultiFab x(ba, dm, ncomp, 1, MFInfo(), factory);
+        MultiFab& y = *m_cheb_work[amrlev][mglev][0];
+        x.setVal(0.0);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(x,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            Array4<Real> const& dfab = dinv->array(mfi);
+            Array4<Real> const& xfab = x.array(mfi);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+            {
+                dfab(i,j,k,n) = (dfab(i,j,k,n) != 0.0) ? 1.0/dfab(i,j,k,n) : 0.0;
+                // Pseudo-random start vector that does not depend on the box layout
+                unsigned int h = static_cast<unsigned int>(i)*73856093U
+                    ^ static_cast<unsigned int>(j)*19349663U
+                    ^ static_cast<unsigned int>(k)*83492791U
+                    ^ static_cast<unsigned int>(n)*2654435761U;
+                h = (h ^ (h >> 16)) * 0x45d9f3bU;
+                h = h ^ (h >> 16);
+                xfab(i,j,k,n) = static_cast<Real>(h & 0xffffU) / 65535.0 - 0.5;
+            });
+        }
+
+        // Power iteration on D^{-1}A
+        constexpr int npower = 10;
+        Real lambda = 0.0;
+        Real xnorm = std::sqrt(MultiFab::Dot(x, 0, x, 0, ncomp, 0));
+        for (int it = 0; it < npower && xnorm > 0.0; ++it)
+        {
+            x.mult(1.0/xnorm, 0, ncomp, 0);
+            apply(amrlev, mglev, y, x, BCMode::Homogeneous, StateMode::Correction);
+            MultiFab::Multiply(y, *dinv, 0, 0, ncomp, 0);
+            xnorm = std::sqrt(MultiFab::Dot(y, 0, y, 0, ncomp, 0));
+            lambda = xnorm;
+            MultiFab::Copy(x, y, 0, 0, ncomp, 0);
+        }
+        m_cheb_lambda_max[amrlev][mglev] = lambda;
+
+        if (verbose > 1) {
+            amrex::Print() << "MLLinOp: Chebyshev smoother on AMR level " << amrlev
+                           << " MG level " << mglev << ": lambda_max(D^-1 A) ~ "
+                           << lambda << "\n";
+        }
+    }
+
+    lambda_max = m_cheb_lambda_max[amrlev][mglev];
+    return *m_cheb_dinv[amrlev][mglev];
+}
+
+// Chebyshev polynomial of D^{-1}A targeting the eigenvalues in
+// [lambda_max/eig_ratio, lambda_max].  Each step needs one application of
+// the operator, i.e., one ghost cell exchange.
+void
+MLLinOp::chebyshevSmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs) const
+{
+    BL_PROFILE("MLLinOp::chebyshevSmooth()");
+
+    const int ncomp = getNComp();
+
+    Real lambda_max;
+    const MultiFab& dinv = chebyshevData(amrlev, mglev, lambda_max);
+    if (lambda_max <= 0.0) return;
+
+    constexpr Real eig_boost = 1.1;
+    constexpr Real eig_ratio = 6.0;
+    const Real lmax = eig_boost*lambda_max;
+    const Real lmin = lmax/eig_ratio;
+    const Real theta = 0.5*(lmax+lmin);
+    const Real delta = 0.5*(lmax-lmin);
+    const Real sigma = theta/delta;
+    Real rho = 1.0/sigma;
+
+    MultiFab& ax = *m_cheb_work[amrlev][mglev][0];
+    MultiFab& d  = *m_cheb_work[amrlev][mglev][1];
+    d.setVal(0.0);
+
+    for (int step = 0; step < info.chebyshev_degree; ++step)
+    {
+        Real c1, c2;
+        if (step == 0) {
+            c1 = 0.0;
+            c2 = 1.0/theta;
+        } else {
+            const Real rho_new = 1.0/(2.0*sigma - rho);
+            c1 = rho_new*rho;
+            c2 = 2.0*rho_new/delta;
+            rho = rho_new;
+        }
+
+        apply(amrlev, mglev, ax, sol, BCMode::Homogeneous, StateMode::Solution);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(d,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            Array4<Real> const& xfab = sol.array(mfi);
+            Array4<Real> const& dfab = d.array(mfi);
+            Array4<Real const> const& axfab = ax.const_array(mfi);
+            Array4<Real const> const& bfab = rhs.const_array(mfi);
+            Array4<Real const> const& difab = dinv.const_array(mfi);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+            {
+                dfab(i,j,k,n) = c1*dfab(i,j,k,n)
+                    + c2*difab(i,j,k,n)*(bfab(i,j,k,n)-axfab(i,j,k,n));
+                xfab(i,j,k,n) += dfab(i,j,k,n);
+            });
+        }
+    }
+}
+
 void
 MLLinOp::setDomainBC (const Array<BCType,AMREX_SPACEDIM>& a_lobc,
                       const Array<BCType,AMREX_SPACEDIM>& a_hibc) noexcept
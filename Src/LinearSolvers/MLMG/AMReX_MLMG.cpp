@@ -39,6 +39,32 @@
 
 namespace amrex {
 
+namespace {
+
+// Copy the valid cells of src to dst, converting between precisions.
+template <typename DFAB, typename SFAB>
+void copyPrecision (FabArray<DFAB>& dst, FabArray<SFAB> const& src, int ncomp)
+{
+    using T = typename DFAB::value_type;
+    using U = typename SFAB::value_type;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(dst,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<T> const& d = dst.array(mfi);
+        Array4<U const> const& s = src.const_array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            d(i,j,k,n) = static_cast<T>(s(i,j,k,n));
+        });
+    }
+}
+
+}
+
 MLMG::MLMG (MLLinOp& a_lp)
     : linop(a_lp),
       namrlevs(a_lp.NAMRLevels()),
@@ -58,15 +84,6 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
         checkPoint(a_sol, a_rhs, a_tol_rel, a_tol_abs, checkpoint_file);
     }
 
-    if (bottom_solver == BottomSolver::Default) {
-        bottom_solver = linop.getDefaultBottomSolver();
-    }
-
-    if (bottom_solver == BottomSolver::hypre) {
-        int mo = linop.getMaxOrder();
-        linop.setMaxOrder(std::min(3,mo));  // maxorder = 4 not supported
-    }
-    
     bool is_nsolve = linop.m_parent;
 
     Real solve_start_time = amrex::second();
@@ -76,7 +93,9 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
     m_niters_cg.clear();
     m_iter_fine_resnorm0.clear();
 
-    prepareForSolve(a_sol, a_rhs);
+    const long nallocs0 = The_Arena()->numAllocs();
+
+    prepare(a_sol, a_rhs);
 
     computeMLResidual(finest_amr_lev);
 
@@ -117,11 +136,14 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
     } else {
         Real iter_start_time = amrex::second();
         bool converged = false;
+        const Long nhalo0 = linop.numHaloExchanges();
+        int num_iters = 0;
 
         const int niters = do_fixed_number_of_iters ? do_fixed_number_of_iters : max_iters;
         for (int iter = 0; iter < niters; ++iter)
         {
             oneIter(iter);
+            ++num_iters;
 
             converged = false;
 
@@ -176,6 +198,11 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
             amrex::Abort("MLMG failed");
         }
         timer[iter_time] = amrex::second() - iter_start_time;
+        if (verbose >= 2 && num_iters > 0) {
+            // Including the residual computation after each iteration
+            amrex::Print() << "MLMG: Halo exchanges per iteration = "
+                           << Real(linop.numHaloExchanges()-nhalo0)/num_iters << "\n";
+        }
     }
 
     int ng_back = final_fill_bc ? 1 : 0;
@@ -199,6 +226,12 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
         }
     }
 
+    if (verbose >= 2) {
+        long nallocs = The_Arena()->numAllocs() - nallocs0;
+        ParallelReduce::Max<long>(nallocs, 0, ParallelContext::CommunicatorSub());
+        amrex::Print() << "MLMG: Arena allocations in this solve = " << nallocs << "\n";
+    }
+
     ++solve_called;
 
     return composite_norminf;
@@ -341,7 +374,9 @@ MLMG::computeResWithCrseSolFineCor (int calev, int falev)
 #ifdef AMREX_USE_EB
         amrex::EB_average_down(fine_res, crse_res, 0, ncomp, amrrr);
 #else
-        amrex::average_down(fine_res, crse_res, 0, ncomp, amrrr);
+        MultiFab& tmpmf = makeAmrCfine(avg_amr_cfine, fine_res, falev, 0);
+        amrex::average_down(fine_res, tmpmf, 0, ncomp, amrrr);
+        crse_res.ParallelCopy(tmpmf, 0, 0, ncomp);
 #endif
     }
 }
@@ -404,7 +439,13 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
 
     const int mglev_bottom = linop.NMGLevels(amrlev) - 1;
 
-    for (int mglev = mglev_top; mglev < mglev_bottom; ++mglev)
+    // MG levels from mglev_sp down are done in single precision.  The top
+    // level stays in double, so that the V-cycles of an F-cycle on the
+    // coarse levels still improve the solution beyond float accuracy.
+    const int mglev_sp = (amrlev == 0 && useSinglePrecision(mglev_top))
+        ? std::max(sp_level, mglev_top+1) : mglev_bottom;
+
+    for (int mglev = mglev_top; mglev < mglev_sp; ++mglev)
     {
         std::string blp_mgv_down_lev_str = make_str("MLMG::mgVcycle_down::", mglev);
         BL_PROFILE_VAR(blp_mgv_down_lev_str, blp_mgv_down_lev);
@@ -417,12 +458,14 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
         }
 
         cor[amrlev][mglev]->setVal(0.0);
-        bool skip_fillboundary = true;
-        for (int i = 0; i < nu1; ++i) {
-            linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
-                         skip_fillboundary);
-            skip_fillboundary = false;
+        if (smootherGhostDepth(amrlev, mglev) > 1) {
+            // multiSweepSmooth needs res in the ghost cells too.
+            res[amrlev][mglev].FillBoundary(linop.Geom(amrlev,mglev).periodicity());
+            ++linop.m_num_halo_exchanges;
         }
+        const bool skip_fillboundary = true;
+        linop.multiSweepSmooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
+                               nu1, skip_fillboundary);
 
         // rescor = res - L(cor)
         computeResOfCorrection(amrlev, mglev);
@@ -439,50 +482,57 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
 
     }
 
-    BL_PROFILE_VAR("MLMG::mgVcycle_bottom", blp_bottom);
-    if (amrlev == 0)
+    if (mglev_sp < mglev_bottom)
     {
-        if (verbose >= 4)
-        {
-            Real norm = res[amrlev][mglev_bottom].norm0();
-            amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev_bottom
-                           << "   DN: Norm before bottom " << norm << "\n";
-        }
-        bottomSolve();
-        if (verbose >= 4)
-        {
-            computeResOfCorrection(amrlev, mglev_bottom);
-            Real norm = rescor[amrlev][mglev_bottom].norm0();
-            amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev_bottom
-                           << "   UP: Norm after  bottom " << norm << "\n";
-        }
+        mgVcycleSP(mglev_sp);
     }
     else
     {
-        if (verbose >= 4)
+        BL_PROFILE_VAR("MLMG::mgVcycle_bottom", blp_bottom);
+        if (amrlev == 0)
         {
-            Real norm = res[amrlev][mglev_bottom].norm0();
-            amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev_bottom 
-                           << "       Norm before smooth " << norm << "\n";
-        }
-        cor[amrlev][mglev_bottom]->setVal(0.0);
-        bool skip_fillboundary = true;
-        for (int i = 0; i < nu1; ++i) {
-            linop.smooth(amrlev, mglev_bottom, *cor[amrlev][mglev_bottom], res[amrlev][mglev_bottom],
-                         skip_fillboundary);
-            skip_fillboundary = false;
+            if (verbose >= 4)
+            {
+                Real norm = res[amrlev][mglev_bottom].norm0();
+                amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev_bottom
+                               << "   DN: Norm before bottom " << norm << "\n";
+            }
+            bottomSolve();
+            if (verbose >= 4)
+            {
+                computeResOfCorrection(amrlev, mglev_bottom);
+                Real norm = rescor[amrlev][mglev_bottom].norm0();
+                amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev_bottom
+                               << "   UP: Norm after  bottom " << norm << "\n";
+            }
         }
-        if (verbose >= 4)
+        else
         {
-	    computeResOfCorrection(amrlev, mglev_bottom);
-            Real norm = rescor[amrlev][mglev_bottom].norm0();
-            amrex::Print() << "AT LEVEL "  << amrlev  << " " << mglev_bottom 
-                           << "       Norm after  smooth " << norm << "\n";
+            if (verbose >= 4)
+            {
+                Real norm = res[amrlev][mglev_bottom].norm0();
+                amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev_bottom 
+                               << "       Norm before smooth " << norm << "\n";
+            }
+            cor[amrlev][mglev_bottom]->setVal(0.0);
+            bool skip_fillboundary = true;
+            for (int i = 0; i < nu1; ++i) {
+                linop.smooth(amrlev, mglev_bottom, *cor[amrlev][mglev_bottom], res[amrlev][mglev_bottom],
+                             skip_fillboundary);
+                skip_fillboundary = false;
+            }
+            if (verbose >= 4)
+            {
+                computeResOfCorrection(amrlev, mglev_bottom);
+                Real norm = rescor[amrlev][mglev_bottom].norm0();
+                amrex::Print() << "AT LEVEL "  << amrlev  << " " << mglev_bottom 
+                               << "       Norm after  smooth " << norm << "\n";
+            }
         }
+        BL_PROFILE_VAR_STOP(blp_bottom);
     }
-    BL_PROFILE_VAR_STOP(blp_bottom);
 
-    for (int mglev = mglev_bottom-1; mglev >= mglev_top; --mglev)
+    for (int mglev = mglev_sp-1; mglev >= mglev_top; --mglev)
     {
         std::string blp_mgv_up_lev_str = make_str("MLMG::mgVcycle_up::", mglev);
         BL_PROFILE_VAR(blp_mgv_up_lev_str, blp_mgv_up_lev);
@@ -495,9 +545,7 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
             amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev
                            << "   UP: Norm before smooth " << norm << "\n";
         }
-        for (int i = 0; i < nu2; ++i) {
-            linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev]);
-        }
+        linop.multiSweepSmooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev], nu2);
 
 	if (cf_strategy == CFStrategy::ghostnodes) computeResOfCorrection(amrlev, mglev);
 
@@ -511,6 +559,75 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
     }
 }
 
+bool
+MLMG::useSinglePrecision (int mglev_top) const
+{
+    return sp_level >= 0 && linop.supportsSinglePrecision()
+        && cf_strategy != CFStrategy::ghostnodes
+        && std::max(sp_level, mglev_top+1) < linop.NMGLevels(0) - 1;
+}
+
+// Number of ghost cells of cor and res for multiSweepSmooth on this level,
+// or 0 if it is not used.
+int
+MLMG::smootherGhostDepth (int amrlev, int mglev) const
+{
+    if (smooth_ghost_depth > 1 && amrlev == 0 && mglev >= smooth_ghost_mglev
+        && mglev < linop.NMGLevels(0) - 1 && linop.isCellCentered()
+        && cf_strategy == CFStrategy::none && linop.getSmoother() == Smoother::Default
+        && linop.supportsDeepGhostSmooth(amrlev, mglev))
+    {
+        return smooth_ghost_depth;
+    }
+    return 0;
+}
+
+// V-cycle on AMR level 0 from mglev_top down in single precision.  The
+// bottom solve is still done in double precision.
+// in  : res[0][mglev_top]
+// out : cor[0][mglev_top]
+void
+MLMG::mgVcycleSP (int mglev_top)
+{
+    BL_PROFILE("MLMG::mgVcycleSP()");
+
+    const int amrlev = 0;
+    const int mglev_bottom = linop.NMGLevels(amrlev) - 1;
+    const int ncomp = linop.getNComp();
+
+    copyPrecision(*res_sp[mglev_top], res[amrlev][mglev_top], ncomp);
+
+    for (int mglev = mglev_top; mglev < mglev_bottom; ++mglev)
+    {
+        cor_sp[mglev]->setVal(0.0f);
+        bool skip_fillboundary = true;
+        for (int i = 0; i < nu1; ++i) {
+            linop.smoothSP(amrlev, mglev, *cor_sp[mglev], *res_sp[mglev], skip_fillboundary);
+            skip_fillboundary = false;
+        }
+
+        linop.correctionResidualSP(amrlev, mglev, *rescor_sp[mglev], *cor_sp[mglev], *res_sp[mglev]);
+
+        linop.restrictionSP(amrlev, mglev+1, *res_sp[mglev+1], *rescor_sp[mglev]);
+    }
+
+    BL_PROFILE_VAR("MLMG::mgVcycle_bottom", blp_bottom);
+    copyPrecision(res[amrlev][mglev_bottom], *res_sp[mglev_bottom], ncomp);
+    bottomSolve();
+    copyPrecision(*cor_sp[mglev_bottom], *cor[amrlev][mglev_bottom], ncomp);
+    BL_PROFILE_VAR_STOP(blp_bottom);
+
+    for (int mglev = mglev_bottom-1; mglev >= mglev_top; --mglev)
+    {
+        linop.interpolationSP(amrlev, mglev, *cor_sp[mglev], *cor_sp[mglev+1]);
+        for (int i = 0; i < nu2; ++i) {
+            linop.smoothSP(amrlev, mglev, *cor_sp[mglev], *res_sp[mglev]);
+        }
+    }
+
+    copyPrecision(*cor[amrlev][mglev_top], *cor_sp[mglev_top], ncomp);
+}
+
 // FMG cycle on the coarsest AMR level.
 // in:  Residual on the top MG level (i.e., 0)
 // out: Correction (cor) on all MG levels
@@ -567,10 +684,8 @@ MLMG::interpCorrection (int alev)
     const MultiFab& crse_cor = *cor[alev-1][0];
     MultiFab& fine_cor = *cor[alev][0];
 
-    BoxArray ba = fine_cor.boxArray();
     const int amrrr = linop.AMRRefRatio(alev-1);
     IntVect refratio{amrrr};
-    ba.coarsen(refratio);
 
     const Geometry& crse_geom = linop.Geom(alev-1,0);
 
@@ -581,7 +696,7 @@ MLMG::interpCorrection (int alev)
         ng_src = nghost;
         ng_dst = nghost;
     }
-    MultiFab cfine(ba, fine_cor.DistributionMap(), ncomp, ng_dst);
+    MultiFab& cfine = makeAmrCfine(cor_amr_cfine, fine_cor, alev, ng_dst);
     cfine.setVal(0.0);
     cfine.ParallelCopy(crse_cor, 0, 0, ncomp, ng_src, ng_dst, crse_geom.periodicity());
 
@@ -703,13 +818,9 @@ MLMG::interpCorrection (int alev, int mglev)
     MultiFab& fine_cor = *cor[alev][mglev  ];
 
     const int ncomp = linop.getNComp();
-    int nghost = 0;
-    if (cf_strategy == CFStrategy::ghostnodes) nghost = linop.getNGrow();
 
     const Geometry& crse_geom = linop.Geom(alev,mglev+1);
-    const int refratio = 2;
 
-    MultiFab cfine;
     const MultiFab* cmf;
     
     if (amrex::isMFIterSafe(crse_cor, fine_cor))
@@ -719,11 +830,8 @@ MLMG::interpCorrection (int alev, int mglev)
     }
     else
     {
-        BoxArray cba = fine_cor.boxArray();
-        cba.coarsen(refratio);
-        int ng = linop.isCellCentered() ? crse_cor.nGrow() : 0;
-        if (cf_strategy == CFStrategy::ghostnodes) ng = nghost;
-        cfine.define(cba, fine_cor.DistributionMap(), ncomp, ng);
+        MultiFab& cfine = makeCorCfine(alev, mglev);
+        const int ng = cfine.nGrow();
         cfine.setVal(0.0);
         cfine.ParallelCopy(crse_cor, 0, 0, ncomp, 0, ng, crse_geom.periodicity());
         cmf = & cfine;
@@ -812,8 +920,6 @@ MLMG::addInterpCorrection (int alev, int mglev)
     const MultiFab& crse_cor = *cor[alev][mglev+1];
     MultiFab&       fine_cor = *cor[alev][mglev  ];
 
-    const int refratio = 2;
-    MultiFab cfine;
     const MultiFab* cmf;
 
     if (amrex::isMFIterSafe(crse_cor, fine_cor))
@@ -822,17 +928,58 @@ MLMG::addInterpCorrection (int alev, int mglev)
     }
     else
     {
-        BoxArray cba = fine_cor.boxArray();
-        cba.coarsen(refratio);
-        const int ng = 0;
-        cfine.define(cba, fine_cor.DistributionMap(), ncomp, ng);
-        cfine.ParallelCopy(crse_cor);
+        MultiFab& cfine = makeCorCfine(alev, mglev);
+        cfine.ParallelCopy(crse_cor, 0, 0, ncomp);
         cmf = &cfine;
     }
 
     linop.interpolation(alev, mglev, fine_cor, *cmf);
 }
 
+// cor[alev][mglev+1] on the coarsened BoxArray of cor[alev][mglev], for
+// when the BoxArray has been agglomerated.  It is allocated on first use.
+MultiFab&
+MLMG::makeCorCfine (int alev, int mglev)
+{
+    if (cor_cfine.empty()) {
+        cor_cfine.resize(namrlevs);
+        for (int amrlev = 0; amrlev < namrlevs; ++amrlev) {
+            cor_cfine[amrlev].resize(linop.NMGLevels(amrlev));
+        }
+    }
+
+    auto& cfine = cor_cfine[alev][mglev];
+    if (cfine == nullptr)
+    {
+        const MultiFab& crse_cor = *cor[alev][mglev+1];
+        const MultiFab& fine_cor = *cor[alev][mglev  ];
+        BoxArray cba = fine_cor.boxArray();
+        cba.coarsen(2);
+        int ng = linop.isCellCentered() ? crse_cor.nGrow() : 0;
+        if (cf_strategy == CFStrategy::ghostnodes) ng = linop.getNGrow();
+        cfine.reset(new MultiFab(cba, fine_cor.DistributionMap(), linop.getNComp(), ng));
+    }
+    return *cfine;
+}
+
+// fine coarsened by the ratio between AMR levels falev-1 and falev, on the
+// DistributionMapping of fine.  It is allocated on first use.
+MultiFab&
+MLMG::makeAmrCfine (Vector<std::unique_ptr<MultiFab> >& cfine, const MultiFab& fine,
+                    int falev, int nghost)
+{
+    if (cfine.empty()) cfine.resize(namrlevs);
+
+    auto& mf = cfine[falev];
+    if (mf == nullptr || mf->nGrow() != nghost
+        || mf->DistributionMap() != fine.DistributionMap())
+    {
+        const BoxArray& cba = amrex::coarsen(fine.boxArray(), linop.AMRRefRatio(falev-1));
+        mf.reset(new MultiFab(cba, fine.DistributionMap(), linop.getNComp(), nghost));
+    }
+    return *mf;
+}
+
 // Compute rescor = res - L(cor)
 // in   : res
 // inout: cor (out due to FillBoundary in linop.correctionResidual)
@@ -910,13 +1057,14 @@ MLMG::actualBottomSolve ()
     else
     {
         MultiFab* bottom_b = &b;
-        MultiFab raii_b;
         if (linop.isBottomSingular())
         {
-            raii_b.define(b.boxArray(), b.DistributionMap(), ncomp, b.nGrow(),
-                          MFInfo(), *linop.Factory(amrlev,mglev));
-            MultiFab::Copy(raii_b,b,0,0,ncomp,b.nGrow());
-            bottom_b = &raii_b;
+            if (bottom_b_raii == nullptr) {
+                bottom_b_raii.reset(new MultiFab(b.boxArray(), b.DistributionMap(), ncomp, b.nGrow(),
+                                                 MFInfo(), *linop.Factory(amrlev,mglev)));
+            }
+            MultiFab::Copy(*bottom_b_raii,b,0,0,ncomp,b.nGrow());
+            bottom_b = bottom_b_raii.get();
 
             makeSolvable(amrlev,mglev,*bottom_b);
         }
@@ -935,6 +1083,12 @@ MLMG::actualBottomSolve ()
             if (bottom_solver == BottomSolver::cg ||
                 bottom_solver == BottomSolver::cgbicg) {
                 cg_type = MLCGSolver::Type::CG;
+            } else if (bottom_solver == BottomSolver::pipelined_bicgstab) {
+                cg_type = MLCGSolver::Type::PipelinedBiCGStab;
+            } else if (bottom_solver == BottomSolver::pipelined_cg) {
+                cg_type = MLCGSolver::Type::PipelinedCG;
+            } else if (bottom_solver == BottomSolver::sstep_cg) {
+                cg_type = MLCGSolver::Type::SStepCG;
             } else {
                 cg_type = MLCGSolver::Type::BiCGStab;
             }
@@ -977,9 +1131,11 @@ int
 MLMG::bottomSolveWithCG (MultiFab& x, const MultiFab& b, MLCGSolver::Type type)
 {
     MLCGSolver cg_solver(this, linop);
+    cg_solver.setWorkspace(&bottom_cg_workspace);
     cg_solver.setSolver(type);
     cg_solver.setVerbose(bottom_verbose);
     cg_solver.setMaxIter(bottom_maxiter);
+    cg_solver.setSStep(bottom_sstep);
     if (cf_strategy == CFStrategy::ghostnodes) cg_solver.setNGhost(linop.getNGrow());
 
     int ret = cg_solver.solve(x, b, bottom_reltol, bottom_abstol);
@@ -1097,6 +1253,23 @@ MLMG::buildFineMask ()
     }
 }
 
+void
+MLMG::prepare (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs)
+{
+    BL_PROFILE("MLMG::prepare()");
+
+    if (bottom_solver == BottomSolver::Default) {
+        bottom_solver = linop.getDefaultBottomSolver();
+    }
+
+    if (bottom_solver == BottomSolver::hypre) {
+        int mo = linop.getMaxOrder();
+        linop.setMaxOrder(std::min(3,mo));  // maxorder = 4 not supported
+    }
+
+    prepareForSolve(a_sol, a_rhs);
+}
+
 void
 MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs)
 {
@@ -1111,23 +1284,7 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
     int nghost = 0;
     if (cf_strategy == CFStrategy::ghostnodes) nghost = linop.getNGrow();
 
-    if (!linop_prepared) {
-        linop.prepareForSolve();
-        linop_prepared = true;
-    } else if (linop.needsUpdate()) {
-        linop.update();
-    }
-
-#ifdef AMREX_USE_HYPRE
-    hypre_solver.reset();
-    hypre_bndry.reset();
-    hypre_node_solver.reset();
-#endif
-
-#ifdef AMREX_USE_PETSC
-    petsc_solver.reset(); 
-    petsc_bndry.reset(); 
-#endif
+    updateLinOp();
 
     sol.resize(namrlevs);
     sol_raii.resize(namrlevs);
@@ -1144,7 +1301,7 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         }
         else
         {
-            if (!solve_called) {
+            if (!mg_prepared) {
                 sol_raii[alev].reset(new MultiFab(a_sol[alev]->boxArray(),
                                                   a_sol[alev]->DistributionMap(), ncomp, 1,
                                                   MFInfo(), *linop.Factory(alev)));
@@ -1158,7 +1315,7 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
     rhs.resize(namrlevs);
     for (int alev = 0; alev < namrlevs; ++alev)
     {
-        if (!solve_called) {
+        if (!mg_prepared) {
             rhs[alev].define(a_rhs[alev]->boxArray(), a_rhs[alev]->DistributionMap(), ncomp, nghost,
                              MFInfo(), *linop.Factory(alev));
         }
@@ -1191,9 +1348,18 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
 
     int ng = linop.isCellCentered() ? 0 : 1;
     if (cf_strategy == CFStrategy::ghostnodes) ng = nghost;
-    if (!solve_called) {
+    if (!mg_prepared) {
         linop.make(res, ncomp, ng);
         linop.make(rescor, ncomp, ng);
+        for (int mglev = 0; mglev < linop.NMGLevels(0); ++mglev)
+        {
+            const int ngs = smootherGhostDepth(0, mglev);
+            if (ngs > ng) {
+                const BoxArray ba = res[0][mglev].boxArray();
+                const DistributionMapping dm = res[0][mglev].DistributionMap();
+                res[0][mglev] = MultiFab(ba, dm, ncomp, ngs, MFInfo(), *linop.Factory(0,mglev));
+            }
+        }
     }
     for (int alev = 0; alev <= finest_amr_lev; ++alev)
     {
@@ -1213,10 +1379,11 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         cor[alev].resize(nmglevs);
         for (int mglev = 0; mglev < nmglevs; ++mglev)
         {
-            if (!solve_called) {
+            if (!mg_prepared) {
+                const int ngc = std::max(ng, smootherGhostDepth(alev, mglev));
                 cor[alev][mglev].reset(new MultiFab(res[alev][mglev].boxArray(),
                                                     res[alev][mglev].DistributionMap(),
-                                                    ncomp, ng, MFInfo(),
+                                                    ncomp, ngc, MFInfo(),
                                                     *linop.Factory(alev,mglev)));
             }
             cor[alev][mglev]->setVal(0.0);
@@ -1230,10 +1397,10 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         cor_hold[alev].resize(nmglevs);
         for (int mglev = 0; mglev < nmglevs-1; ++mglev)
         {
-            if (!solve_called) {
+            if (!mg_prepared) {
                 cor_hold[alev][mglev].reset(new MultiFab(cor[alev][mglev]->boxArray(),
                                                          cor[alev][mglev]->DistributionMap(),
-                                                         ncomp, ng, MFInfo(),
+                                                         ncomp, cor[alev][mglev]->nGrow(), MFInfo(),
                                                          *linop.Factory(alev,mglev)));
             }
             cor_hold[alev][mglev]->setVal(0.0);
@@ -1242,7 +1409,7 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
     for (int alev = 1; alev < finest_amr_lev; ++alev)
     {
         cor_hold[alev].resize(1);
-        if (!solve_called) {
+        if (!mg_prepared) {
             cor_hold[alev][0].reset(new MultiFab(cor[alev][0]->boxArray(),
                                                  cor[alev][0]->DistributionMap(),
                                                  ncomp, ng, MFInfo(),
@@ -1251,9 +1418,27 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         cor_hold[alev][0]->setVal(0.0);
     }
 
+    if (sp_level >= 0 && linop.supportsSinglePrecision())
+    {
+        const int nmglevs = linop.NMGLevels(0);
+        res_sp.resize(nmglevs);
+        cor_sp.resize(nmglevs);
+        rescor_sp.resize(nmglevs);
+        for (int mglev = sp_level; mglev < nmglevs; ++mglev)
+        {
+            if (res_sp[mglev] == nullptr) {
+                const BoxArray& ba = res[0][mglev].boxArray();
+                const DistributionMapping& dm = res[0][mglev].DistributionMap();
+                res_sp   [mglev].reset(new MLLinOp::FloatMultiFab(ba, dm, ncomp, 0));
+                cor_sp   [mglev].reset(new MLLinOp::FloatMultiFab(ba, dm, ncomp, 1));
+                rescor_sp[mglev].reset(new MLLinOp::FloatMultiFab(ba, dm, ncomp, 0));
+            }
+        }
+    }
+
     buildFineMask();
 
-    if (!solve_called)
+    if (!mg_prepared)
     {
         scratch.resize(namrlevs);
 #ifdef AMREX_USE_EB
@@ -1279,6 +1464,24 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         prepareForNSolve();
     }
 
+    if (!mg_prepared && sp_level >= 0 && verbose >= 1)
+    {
+        if (!linop.supportsSinglePrecision()) {
+            amrex::Print() << "MLMG: setSinglePrecisionLevel ignored: only the cross-stencil"
+                           << " MLABecLaplacian supports single precision MG levels\n";
+        } else if (cf_strategy == CFStrategy::ghostnodes) {
+            amrex::Print() << "MLMG: setSinglePrecisionLevel ignored with CFStrategy::ghostnodes\n";
+        } else if (sp_level >= linop.NMGLevels(0) - 1) {
+            amrex::Print() << "MLMG: setSinglePrecisionLevel(" << sp_level << ") ignored: "
+                           << "the coarsest AMR level has " << linop.NMGLevels(0)
+                           << " MG levels, and the last one is the bottom\n";
+        } else if (namrlevs > 1) {
+            amrex::Print() << "MLMG: single precision MG levels are only used on AMR level 0\n";
+        }
+    }
+
+    mg_prepared = true;
+
     if (verbose >= 2) {
         amrex::Print() << "MLMG: # of AMR levels: " << namrlevs << "\n"
                        << "      # of MG levels on the coarsest AMR level: " << linop.NMGLevels(0)
@@ -1290,6 +1493,34 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
     }
 }
 
+// The operator is prepared on first use.  After that only its coefficients
+// are updated, if they have changed.  The MG temporaries are allocated once
+// in prepareForSolve, but the bottom solvers' matrices depend on the
+// coefficients.
+void
+MLMG::updateLinOp ()
+{
+    if (!linop_prepared) {
+        linop.prepareForSolve();
+        linop_prepared = true;
+    } else if (linop.needsUpdate()) {
+        linop.update();
+    } else {
+        return;
+    }
+
+#ifdef AMREX_USE_HYPRE
+    hypre_solver.reset();
+    hypre_bndry.reset();
+    hypre_node_solver.reset();
+#endif
+
+#ifdef AMREX_USE_PETSC
+    petsc_solver.reset(); 
+    petsc_bndry.reset(); 
+#endif
+}
+
 void
 MLMG::prepareForNSolve ()
 {
@@ -1458,12 +1689,7 @@ MLMG::compResidual (const Vector<MultiFab*>& a_res, const Vector<MultiFab*>& a_s
         }
     }
 
-    if (!linop_prepared) {
-        linop.prepareForSolve();
-        linop_prepared = true;
-    } else if (linop.needsUpdate()) {
-        linop.update();
-    }
+    updateLinOp();
     
     const auto& amrrr = linop.AMRRefRatio();
 
@@ -1540,12 +1766,7 @@ MLMG::apply (const Vector<MultiFab*>& out, const Vector<MultiFab*>& a_in)
         rh[alev].setVal(0.0);
     }
 
-    if (!linop_prepared) {
-        linop.prepareForSolve();
-        linop_prepared = true;
-    } else if (linop.needsUpdate()) {
-        linop.update();
-    }
+    updateLinOp();
 
     const auto& amrrr = linop.AMRRefRatio();
 
@@ -1592,7 +1813,9 @@ MLMG::averageDownAndSync ()
 #ifdef AMREX_USE_EB
             amrex::EB_average_down(*sol[falev], *sol[falev-1], 0, ncomp, amrrr[falev-1]);
 #else
-            amrex::average_down(*sol[falev], *sol[falev-1], 0, ncomp, amrrr[falev-1]);
+            MultiFab& tmpmf = makeAmrCfine(avg_amr_cfine, *sol[falev], falev, 0);
+            amrex::average_down(*sol[falev], tmpmf, 0, ncomp, amrrr[falev-1]);
+            sol[falev-1]->ParallelCopy(tmpmf, 0, 0, ncomp);
 #endif
         }
     }
@@ -1605,7 +1828,7 @@ MLMG::averageDownAndSync ()
             const auto& fmf = *sol[falev];
             auto&       cmf = *sol[falev-1];
 
-            MultiFab tmpmf(amrex::coarsen(fmf.boxArray(), amrrr[falev-1]), fmf.DistributionMap(), ncomp, nghost);
+            MultiFab& tmpmf = makeAmrCfine(avg_amr_cfine, fmf, falev, nghost);
             amrex::average_down(fmf, tmpmf, 0, ncomp, amrrr[falev-1]);
             cmf.ParallelCopy(tmpmf, 0, 0, ncomp);
             linop.nodalSync(falev-1, 0, cmf);
@@ -1616,7 +1839,7 @@ MLMG::averageDownAndSync ()
 void
 MLMG::computeVolInv ()
 {
-    if (solve_called) return;
+    if (!volinv.empty()) return;
 
     if (linop.isCellCentered())
     { 
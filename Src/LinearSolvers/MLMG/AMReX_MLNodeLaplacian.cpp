@@ -1038,6 +1038,8 @@ MLNodeLaplacian::prepareForSolve ()
 #endif
 
     buildStencil();
+
+    clearChebyshevData();
 }
 
 void
@@ -1597,6 +1599,55 @@ MLNodeLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
     }
 }
 
+void
+MLNodeLaplacian::getDiagonal (int amrlev, int mglev, MultiFab& diag) const
+{
+    BL_PROFILE("MLNodeLaplacian::getDiagonal()");
+
+    const auto& sigma = m_sigma[amrlev][mglev];
+    const auto& stencil = m_stencil[amrlev][mglev];
+    const auto dxinv = m_geom[amrlev][mglev].InvCellSizeArray();
+    const iMultiFab& dmsk = *m_dirichlet_mask[amrlev][mglev];
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(diag,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<Real> const& arr = diag.array(mfi);
+        Array4<int const> const& dmskarr = dmsk.const_array(mfi);
+        if (m_coarsening_strategy == CoarseningStrategy::RAP)
+        {
+            Array4<Real const> const& stenarr = stencil->const_array(mfi);
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+            {
+                mlndlap_diag_sten(tbx,arr,stenarr,dmskarr);
+            });
+        }
+        else if (m_use_harmonic_average && mglev > 0)
+        {
+            AMREX_D_TERM(Array4<Real const> const& sxarr = sigma[0]->const_array(mfi);,
+                         Array4<Real const> const& syarr = sigma[1]->const_array(mfi);,
+                         Array4<Real const> const& szarr = sigma[2]->const_array(mfi););
+
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+            {
+                mlndlap_diag_ha(tbx,arr,AMREX_D_DECL(sxarr,syarr,szarr),dmskarr,dxinv);
+            });
+        }
+        else
+        {
+            Array4<Real const> const& sarr = sigma[0]->const_array(mfi);
+
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+            {
+                mlndlap_diag_aa(tbx,arr,sarr,dmskarr,dxinv);
+            });
+        }
+    }
+}
+
 void
 MLNodeLaplacian::compSyncResidualCoarse (MultiFab& sync_resid, const MultiFab& a_phi,
                                          const MultiFab& vold, const MultiFab* rhcc,
@@ -125,6 +125,10 @@ void
 MLNodeLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
                      bool skip_fillboundary) const
 {
+    if (info.smoother == Smoother::chebyshev) {
+        chebyshevSmooth(amrlev, mglev, sol, rhs);
+        return;
+    }
     if (!skip_fillboundary) {
         applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution);
     }
@@ -329,6 +333,7 @@ MLNodeLinOp::applyBC (int amrlev, int mglev, MultiFab& phi, BCMode/* bc_mode*/,
 
     if (!skip_fillboundary) {
         phi.FillBoundary(geom.periodicity());
+        ++m_num_halo_exchanges;
     }
 
     if (m_coarsening_strategy == CoarseningStrategy::Sigma)
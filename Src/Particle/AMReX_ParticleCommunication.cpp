@@ -1,4 +1,5 @@
 #include <AMReX_ParticleCommunication.H>
+#include <AMReX_ParticleUtil.H>
 #include <AMReX_ParallelDescriptor.H>
 
 using namespace amrex;
@@ -42,6 +43,35 @@ void ParticleCopyPlan::clear ()
     m_rcv_box_ids.clear();
 }
 
+void ParticleCopyPlan::buildNeighborProcs (const ParGDBBase* a_gdb, int ngrow)
+{
+    const int num_levels = a_gdb->finestLevel() + 1;
+
+    bool valid = (ngrow == m_neighbor_procs_ngrow) and (num_levels == static_cast<int>(m_neighbor_procs_ba.size()));
+    for (int lev = 0; valid and lev < num_levels; ++lev)
+    {
+        valid = BoxArray::SameRefs(a_gdb->ParticleBoxArray(lev), m_neighbor_procs_ba[lev]) and
+            DistributionMapping::SameRefs(a_gdb->ParticleDistributionMap(lev), m_neighbor_procs_dm[lev]);
+    }
+    if (valid) return;
+
+    BL_PROFILE("ParticleCopyPlan::buildNeighborProcs");
+
+    m_neighbor_procs = computeNeighborProcs(a_gdb, ngrow);
+    m_neighbor_procs_ngrow = ngrow;
+    m_neighbor_procs_ba.resize(num_levels);
+    m_neighbor_procs_dm.resize(num_levels);
+    for (int lev = 0; lev < num_levels; ++lev)
+    {
+        m_neighbor_procs_ba[lev] = a_gdb->ParticleBoxArray(lev);
+        m_neighbor_procs_dm[lev] = a_gdb->ParticleDistributionMap(lev);
+    }
+
+    // Grids that are gone must not be kept around.
+    m_dst_indices.clear();
+    m_snd_data.clear();
+}
+
 void ParticleCopyPlan::buildMPIStart (const ParticleBufferMap& map)
 {
     BL_PROFILE("ParticleCopyPlan::buildMPIStart");
@@ -73,7 +103,7 @@ void ParticleCopyPlan::buildMPIStart (const ParticleBufferMap& map)
 
     Gpu::HostVector<int> box_counts(m_box_counts.size());
     Gpu::copy(Gpu::deviceToHost, m_box_counts.begin(), m_box_counts.end(), box_counts.begin());
-    std::map<int, Vector<int> > snd_data;
+    for (auto& kv : m_snd_data) kv.second.clear();
 
     BL_PROFILE_VAR_STOP(blp_resize);
 
@@ -92,9 +122,10 @@ void ParticleCopyPlan::buildMPIStart (const ParticleBufferMap& map)
             int npart = box_counts[bucket];
             if (npart == 0) continue;
             m_snd_num_particles[i] += npart;
-            snd_data[i].push_back(npart);
-            snd_data[i].push_back(dst);
-            snd_data[i].push_back(lev);
+            auto& snd_data = m_snd_data[i];
+            snd_data.push_back(npart);
+            snd_data.push_back(dst);
+            snd_data.push_back(lev);
             nbytes += 3*sizeof(int);
 	}
 	m_Snds[i] = nbytes;
@@ -177,7 +208,7 @@ void ParticleCopyPlan::buildMPIStart (const ParticleBufferMap& map)
         AMREX_ASSERT(Who >= 0 && Who < NProcs);
         AMREX_ASSERT(Cnt < std::numeric_limits<int>::max());
         
-        ParallelDescriptor::Asend((char*) snd_data[i].data(), Cnt, Who, SeqNum);
+        ParallelDescriptor::Asend((char*) m_snd_data[i].data(), Cnt, Who, SeqNum);
     }
 
     BL_PROFILE_VAR_STOP(blp_second);
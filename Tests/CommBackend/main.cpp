@@ -0,0 +1,164 @@
+#include <AMReX.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_SArena.H>
+
+using namespace amrex;
+
+namespace {
+
+// A value that is different for every cell and component.
+void fillValid (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        Array4<Real> const& a = mf.array(mfi);
+        const int ncomp = mf.nComp();
+        amrex::LoopOnCpu(bx, ncomp, [=] (int i, int j, int k, int n) noexcept
+        {
+            a(i,j,k,n) = i + 1.e2*j + 1.e4*k + 1.e6*n;
+        });
+    }
+}
+
+// Run f with the given backend and return a copy of the result, ghost
+// cells included.
+template <class F>
+MultiFab runWith (FabArrayBase::CommBackend backend, const MultiFab& like, F&& f)
+{
+    const auto old_backend = FabArrayBase::comm_backend;
+    FabArrayBase::comm_backend = backend;
+
+    MultiFab mf(like.boxArray(), like.DistributionMap(), like.nComp(), like.nGrow());
+    f(mf);
+
+    FabArrayBase::comm_backend = old_backend;
+    return mf;
+}
+
+Real maxDiff (MultiFab const& a, MultiFab const& b)
+{
+    MultiFab diff(a.boxArray(), a.DistributionMap(), a.nComp(), a.nGrow());
+    MultiFab::Copy(diff, a, 0, 0, a.nComp(), a.nGrow());
+    MultiFab::Subtract(diff, b, 0, 0, a.nComp(), a.nGrow());
+    Real d = 0.0;
+    for (int n = 0; n < a.nComp(); ++n) {
+        d = std::max(d, diff.norm0(n, a.nGrow()));
+    }
+    return d;
+}
+
+void check (const std::string& name, MultiFab const& p2p, MultiFab const& nbr,
+            const std::string& other = "neighbor")
+{
+    const Real d = maxDiff(p2p, nbr);
+    amrex::Print() << name << ": max difference between p2p and " << other << " is " << d << "\n";
+    if (d != 0.0) {
+        amrex::Abort(name + ": " + other + " does not match p2p");
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int ncomp = 3;
+        int nghost = 2;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncomp", ncomp);
+            pp.query("nghost", nghost);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+        Geometry geom(domain, rb, 0, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab src(ba, dm, ncomp, nghost);
+        src.setVal(-1.0);
+        fillValid(src);
+
+        // FillBoundary, blocking and split.
+        auto fill_boundary = [&] (MultiFab& mf) {
+            MultiFab::Copy(mf, src, 0, 0, ncomp, nghost);
+            mf.FillBoundary(geom.periodicity());
+        };
+        {
+            MultiFab p2p = runWith(FabArrayBase::P2P, src, fill_boundary);
+            // the domain is periodic, so every ghost cell is filled
+            if (p2p.min(0, nghost) < 0.0 || p2p.min(ncomp-1, nghost) < 0.0) {
+                amrex::Abort("FillBoundary: some ghost cells were not filled");
+            }
+            check("FillBoundary", p2p, runWith(FabArrayBase::NEIGHBOR, src, fill_boundary));
+        }
+
+        // FillBoundary of a MultiFab in the shared memory arena copies
+        // directly from the FABs of the other processes on the node.
+        if (SArena* shm = static_cast<SArena*>(The_Shared_Arena()))
+        {
+            MultiFab mf(ba, dm, ncomp, nghost, MFInfo().SetArena(shm));
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                if (!shm->isShared(mf[mfi].dataPtr())) {
+                    amrex::Abort("FillBoundary: amrex.shared_arena_size is too small for this test");
+                }
+            }
+            MultiFab p2p = runWith(FabArrayBase::P2P, src, fill_boundary);
+            for (int iter = 0; iter < 2; ++iter) {
+                MultiFab::Copy(mf, src, 0, 0, ncomp, nghost);
+                mf.FillBoundary(geom.periodicity());
+                check("FillBoundary", p2p, mf, "shared memory");
+            }
+        }
+
+        auto fill_boundary_nowait = [&] (MultiFab& mf) {
+            MultiFab::Copy(mf, src, 0, 0, ncomp, nghost);
+            mf.FillBoundary_nowait(1, ncomp-1, geom.periodicity());
+            mf.FillBoundary_finish();
+        };
+        check("FillBoundary_nowait",
+              runWith(FabArrayBase::P2P, src, fill_boundary_nowait),
+              runWith(FabArrayBase::NEIGHBOR, src, fill_boundary_nowait));
+
+        // ParallelCopy and ParallelAdd to a different BoxArray and a
+        // DistributionMapping with the ranks shifted by one.
+        BoxArray dst_ba(domain);
+        dst_ba.maxSize(max_grid_size*3/2);
+        Vector<int> pmap(dst_ba.size());
+        for (int i = 0; i < dst_ba.size(); ++i) {
+            pmap[i] = (i+1) % ParallelDescriptor::NProcs();
+        }
+        DistributionMapping dst_dm(pmap);
+        MultiFab dst_like(dst_ba, dst_dm, ncomp, nghost);
+
+        auto parallel_copy = [&] (MultiFab& mf) {
+            mf.setVal(-2.0);
+            mf.ParallelCopy(src, 0, 0, ncomp, 0, nghost, geom.periodicity());
+        };
+        check("ParallelCopy",
+              runWith(FabArrayBase::P2P, dst_like, parallel_copy),
+              runWith(FabArrayBase::NEIGHBOR, dst_like, parallel_copy));
+
+        auto parallel_add = [&] (MultiFab& mf) {
+            mf.setVal(1.0);
+            mf.ParallelAdd(src, 0, 0, ncomp, nghost, nghost, geom.periodicity());
+        };
+        check("ParallelAdd",
+              runWith(FabArrayBase::P2P, dst_like, parallel_add),
+              runWith(FabArrayBase::NEIGHBOR, dst_like, parallel_add));
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,214 @@
+#include <AMReX.H>
+#include <AMReX_Machine.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <iomanip>
+
+using namespace amrex;
+
+namespace {
+
+struct TestParams
+{
+    int n_cell = 128;
+    int max_grid_size = 16;
+    Vector<int> nprocs{7, 32, 64};
+    int simulated_node_size = 0;
+};
+
+TestParams get_test_params ()
+{
+    TestParams params;
+    ParmParse pp;
+    pp.query("n_cell", params.n_cell);
+    pp.query("max_grid_size", params.max_grid_size);
+    pp.queryarr("nprocs", params.nprocs);
+    ParmParse("machine").query("simulated_node_size", params.simulated_node_size);
+    return params;
+}
+
+// Ten times heavier inside a sphere, so that the boxes are not all equal.
+Real cellWeight (const IntVect& iv, int n_cell)
+{
+    Real r2 = 0.0;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const Real x = (iv[idim] + 0.5)/n_cell - 0.5;
+        r2 += x*x;
+    }
+    return (r2 < 0.3*0.3) ? 10.0 : 1.0;
+}
+
+// Every box goes to a process in [0,nprocs), and no process is left empty.
+void checkValid (const std::string& name, const DistributionMapping& dm,
+                 const BoxArray& ba, int nprocs)
+{
+    const Vector<int>& pmap = dm.ProcessorMap();
+    if (static_cast<int>(pmap.size()) != ba.size()) {
+        amrex::Abort(name + ": the DistributionMapping does not have one entry per box");
+    }
+    Vector<int> count(nprocs, 0);
+    for (int p : pmap) {
+        if (p < 0 || p >= nprocs) {
+            amrex::Abort(name + ": a box is mapped to a process that does not exist");
+        }
+        ++count[p];
+    }
+    if (ba.size() >= nprocs && *std::min_element(count.begin(), count.end()) == 0) {
+        amrex::Abort(name + ": a process has no box");
+    }
+}
+
+Real imbalance (const DistributionMapping& dm, const std::vector<long>& wgts, int nprocs)
+{
+    Vector<long> load(nprocs, 0);
+    long sum = 0;
+    for (int i = 0; i < dm.size(); ++i) {
+        load[dm[i]] += wgts[i];
+        sum += wgts[i];
+    }
+    return Real(*std::max_element(load.begin(), load.end()))*nprocs/Real(sum);
+}
+
+// Number of ghost cells of one layer that are copied between processes, and
+// the part of it copied between nodes of node_size processes.
+long commVolume (const DistributionMapping& dm, const BoxArray& ba,
+                 int node_size = 0, long* inter_node_volume = nullptr)
+{
+    long vol = 0, inter = 0;
+    std::vector<std::pair<int,Box> > isects;
+    for (int i = 0; i < ba.size(); ++i) {
+        ba.intersections(amrex::grow(ba[i],1), isects);
+        for (const auto& is : isects) {
+            if (dm[is.first] != dm[i]) {
+                vol += is.second.numPts();
+                if (node_size > 0 && dm[is.first]/node_size != dm[i]/node_size) {
+                    inter += is.second.numPts();
+                }
+            }
+        }
+    }
+    if (inter_node_volume) *inter_node_volume = inter;
+    return vol;
+}
+
+void testStrategies (const BoxArray& ba, const std::vector<long>& wgts, int nprocs)
+{
+    // Without sorting, the buckets are not matched to the memory in use on
+    // this run's processes, so nprocs can be more than we have.
+    DistributionMapping sfc, hilbert, graph;
+    sfc.SFCProcessorMap(ba, wgts, nprocs, false);
+    hilbert.HilbertProcessorMap(ba, wgts, nprocs, false);
+    graph.GraphProcessorMap(ba, wgts, nprocs);
+
+    checkValid("SFC", sfc, ba, nprocs);
+    checkValid("HILBERT", hilbert, ba, nprocs);
+    checkValid("GRAPH", graph, ba, nprocs);
+
+    const Real imb_sfc = imbalance(sfc, wgts, nprocs);
+    const Real imb_hilbert = imbalance(hilbert, wgts, nprocs);
+    const Real imb_graph = imbalance(graph, wgts, nprocs);
+    const long vol_hilbert = commVolume(hilbert, ba);
+    const long vol_graph = commVolume(graph, ba);
+
+    amrex::Print() << std::setprecision(4) << ba.size() << " boxes on " << nprocs << " processes:"
+                   << " imbalance SFC " << imb_sfc << ", HILBERT " << imb_hilbert
+                   << ", GRAPH " << imb_graph << "; comm volume SFC " << commVolume(sfc, ba)
+                   << ", HILBERT " << vol_hilbert << ", GRAPH " << vol_graph << "\n";
+
+    // Both curves split the boxes into chunks of about the same weight.
+    if (imb_hilbert > 1.1*imb_sfc) {
+        amrex::Abort("testStrategies: HILBERT is much worse balanced than SFC");
+    }
+    // GRAPH starts from HILBERT and only makes a move if it reduces the
+    // communication and keeps the load within the graph tolerance.
+    Real graph_tolerance = 0.05;
+    ParmParse("DistributionMapping").query("graph_tolerance", graph_tolerance);
+    if (imb_graph > std::max(imb_hilbert, 1.0+graph_tolerance)*(1.0+1.e-12)) {
+        amrex::Abort("testStrategies: GRAPH is outside of its load tolerance");
+    }
+    if (vol_graph > vol_hilbert) {
+        amrex::Abort("testStrategies: GRAPH communicates more than HILBERT");
+    }
+}
+
+// The default mapping on the processes of this run, with a node made of
+// every node_size consecutive ranks.
+void testTopology (const BoxArray& ba, const std::vector<long>& wgts, int node_size)
+{
+    const Vector<int>& node_ids = machine::node_ids();
+    for (int i = 0; i < node_ids.size(); ++i) {
+        if (node_ids[i] != i/node_size) {
+            amrex::Abort("testTopology: wrong simulated node id");
+        }
+    }
+
+    DistributionMapping dm(ba);
+    const auto stats = dm.computeStats(ba, wgts, 1);
+    long inter = 0;
+    const long vol = commVolume(dm, ba, node_size, &inter);
+
+    amrex::Print() << "Default mapping with " << node_size << " processes per node: "
+                   << "intra-node " << stats.comm_volume - stats.inter_node_volume
+                   << ", inter-node " << stats.inter_node_volume << " cells\n";
+
+    if (stats.comm_volume != vol || stats.inter_node_volume != inter) {
+        amrex::Abort("testTopology: computeStats does not match the default mapping");
+    }
+    if (ParallelDescriptor::NProcs() <= node_size && inter != 0) {
+        amrex::Abort("testTopology: inter-node traffic on a single node");
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        const TestParams params = get_test_params();
+
+        const Box domain(IntVect(0), IntVect(params.n_cell-1));
+        BoxArray ba(domain);
+        ba.maxSize(params.max_grid_size);
+
+        std::vector<long> wgts(ba.size());
+        for (int i = 0; i < ba.size(); ++i) {
+            Real w = 0.0;
+            const Box& bx = ba[i];
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                w += cellWeight(iv, params.n_cell);
+            }
+            wgts[i] = static_cast<long>(w);
+        }
+
+        for (int nprocs : params.nprocs) {
+            testStrategies(ba, wgts, nprocs);
+        }
+
+        // The make functions on the processes of this run.
+        const int nprocs = ParallelDescriptor::NProcs();
+        DistributionMapping dm(ba);
+        MultiFab weight(ba, dm, 1, 0);
+        for (MFIter mfi(weight); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.validbox();
+            Array4<Real> const& w = weight.array(mfi);
+            const int n_cell = params.n_cell;
+            amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+            {
+                w(i,j,k) = cellWeight(IntVect(AMREX_D_DECL(i,j,k)), n_cell);
+            });
+        }
+        checkValid("makeSFC", DistributionMapping::makeSFC(weight), ba, nprocs);
+        checkValid("makeHilbert", DistributionMapping::makeHilbert(weight), ba, nprocs);
+        checkValid("makeGraph", DistributionMapping::makeGraph(weight), ba, nprocs);
+
+        if (params.simulated_node_size > 0) {
+            testTopology(ba, wgts, params.simulated_node_size);
+        }
+
+        amrex::Print() << "All DistributionMapping strategies give valid mappings\n";
+    }
+    amrex::Finalize();
+}
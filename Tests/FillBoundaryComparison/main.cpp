@@ -125,39 +125,72 @@ main (int argc, char* argv[])
     }
 
     int nrounds = 1000;
+    // 0: current path only, 1: persistent plan only, 2: both
+    int fb_mode = 2;
     {
 	ParmParse pp;
 	pp.query("nrounds", nrounds);
+	pp.query("fb_mode", fb_mode);
     }
 
-    Real err = 0.0;
+    const long ncalls = 4L * nrounds * nlevels;
 
-    ParallelDescriptor::Barrier();
-    Real wt0 = ParallelDescriptor::second();
+    auto run_rounds = [&] (bool use_plan, Real& err) -> Real
+    {
+	FabArrayBase::use_persistent_fb_plan = use_plan;
 
-    for (int iround = 0; iround < nrounds; ++iround) {
-	for (int c=0; c<2; ++c) {
-	    for (int lev = 0; lev < nlevels; ++lev) {
-		mfs[lev]->FillBoundary_nowait();
-		mfs[lev]->FillBoundary_finish();
-	    }
-	    for (int lev = nlevels-1; lev >= 0; --lev) {
-		mfs[lev]->FillBoundary_nowait();
-		mfs[lev]->FillBoundary_finish();
+	// The first call of each configuration builds the FB (and the plan).
+	for (int lev = 0; lev < nlevels; ++lev) {
+	    mfs[lev]->FillBoundary();
+	}
+
+	ParallelDescriptor::Barrier();
+	Real wt0 = ParallelDescriptor::second();
+
+	for (int iround = 0; iround < nrounds; ++iround) {
+	    for (int c=0; c<2; ++c) {
+		for (int lev = 0; lev < nlevels; ++lev) {
+		    mfs[lev]->FillBoundary_nowait();
+		    mfs[lev]->FillBoundary_finish();
+		}
+		for (int lev = nlevels-1; lev >= 0; --lev) {
+		    mfs[lev]->FillBoundary_nowait();
+		    mfs[lev]->FillBoundary_finish();
+		}
 	    }
+	    Real e = double(iround+ParallelDescriptor::MyProc());
+	    ParallelDescriptor::ReduceRealMax(e);
+	    err += e;
 	}
-	Real e = double(iround+ParallelDescriptor::MyProc());
-	ParallelDescriptor::ReduceRealMax(e);
-	err += e;
+
+	ParallelDescriptor::Barrier();
+	return ParallelDescriptor::second() - wt0;
+    };
+
+    Real err = 0.0;
+    Real t_default = 0.0, t_plan = 0.0;
+
+    if (fb_mode != 1) {
+	t_default = run_rounds(false, err);
+    }
+    if (fb_mode != 0) {
+	t_plan = run_rounds(true, err);
     }
-	    
-    ParallelDescriptor::Barrier();
-    Real wt1 = ParallelDescriptor::second();
 
     if (ParallelDescriptor::IOProcessor()) {
         std::cout << "Using MPI" << std::endl;
 	std::cout << "----------------------------------------------" << std::endl;
-	std::cout << "Fill Boundary Time: " << wt1-wt0 << std::endl;
+	if (fb_mode != 1) {
+	    std::cout << "Fill Boundary Time: " << t_default << std::endl;
+	    std::cout << "    per call (us)        : " << 1.e6*t_default/ncalls << std::endl;
+	}
+	if (fb_mode != 0) {
+	    std::cout << "Fill Boundary Time (persistent plan): " << t_plan << std::endl;
+	    std::cout << "    per call (us)        : " << 1.e6*t_plan/ncalls << std::endl;
+	}
+	if (fb_mode == 2 && t_plan > 0.0) {
+	    std::cout << "Speedup of persistent plan: " << t_default/t_plan << std::endl;
+	}
 	std::cout << "----------------------------------------------" << std::endl;
 	std::cout << "ignore this line " << err << std::endl;
     }
@@ -11,6 +11,7 @@
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_Utility.H>
 #include <AMReX_NFiles.H>
+#include <AMReX_PlotFileUtil.H>
 
 #include <iostream>
 #include <sstream>
@@ -618,3 +619,193 @@ ParallelDescriptor::Barrier();
 // -------------------------------------------------------------
 
 
+
+
+// -------------------------------------------------------------
+// Compare the time the solver is blocked by WriteMultiLevelPlotfile
+// with the exposed time of WriteMultiLevelPlotfileAsync, which is the
+// time of the call plus the time waiting for the future after
+// workTime seconds of simulated computation.
+// -------------------------------------------------------------
+void TestWriteAsyncPlotfile(int nfiles, int maxgrid, int ncomps, int nboxes,
+                            int nLevels, double workTime, bool mb2,
+                            const std::string &dirName)
+{
+  VisMF::SetNOutFiles(nfiles);
+  if(mb2) {
+    bytesPerMB = pow(2.0, 20);
+  }
+
+  BoxArray bArray(MakeBoxArray(maxgrid, nboxes));
+  DistributionMapping dmap{bArray};
+  Box domain(bArray.minimalBox());
+  RealBox realBox(AMREX_D_DECL(0.0, 0.0, 0.0), AMREX_D_DECL(1.0, 1.0, 1.0));
+
+  Vector<std::unique_ptr<MultiFab> > multifabs(nLevels);
+  Vector<const MultiFab *> mfPtrs(nLevels);
+  Vector<Geometry> geoms(nLevels);
+  Vector<int> levelSteps(nLevels, 0);
+  Vector<IntVect> refRatio(std::max(nLevels-1, 1), IntVect::TheUnitVector());
+  Vector<std::string> varNames(ncomps);
+  for(int i(0); i < ncomps; ++i) {
+    varNames[i] = "Var" + std::to_string(i);
+  }
+  // ---- each level covers the same domain
+  for(int lev(0); lev < nLevels; ++lev) {
+    multifabs[lev].reset(new MultiFab(bArray, dmap, ncomps, 0));
+    for(int invar(0); invar < ncomps; ++invar) {
+      multifabs[lev]->setVal(100.0 * lev + invar, invar, 1);
+    }
+    mfPtrs[lev] = multifabs[lev].get();
+    geoms[lev].define(domain, &realBox, 0);
+  }
+
+  std::string pltSync(dirName.empty() ? "pltSync" : dirName + "/pltSync");
+  std::string pltAsync(dirName.empty() ? "pltAsync" : dirName + "/pltAsync");
+  int ioProc(ParallelDescriptor::IOProcessorNumber());
+
+  // ---- synchronous
+  ParallelDescriptor::Barrier("TestWriteAsyncPlotfile:BeforeSyncWrite");
+  double syncTime(ParallelDescriptor::second());
+  WriteMultiLevelPlotfile(pltSync, nLevels, mfPtrs, varNames, geoms, 0.0,
+                          levelSteps, refRatio);
+  syncTime = ParallelDescriptor::second() - syncTime;
+
+  // ---- asynchronous
+  ParallelDescriptor::Barrier("TestWriteAsyncPlotfile:BeforeAsyncWrite");
+  double callTime(ParallelDescriptor::second());
+  auto status = WriteMultiLevelPlotfileAsync(pltAsync, nLevels, mfPtrs, varNames,
+                                             geoms, 0.0, levelSteps, refRatio);
+  callTime = ParallelDescriptor::second() - callTime;
+
+  // ---- the data can be changed right away
+  for(int lev(0); lev < nLevels; ++lev) {
+    multifabs[lev]->setVal(-1.0);
+  }
+  amrex::USleep(workTime);
+
+  double waitTime(ParallelDescriptor::second());
+  WriteAsyncStatus wStatus(status.get());
+  waitTime = ParallelDescriptor::second() - waitTime;
+  double exposedTime(callTime + waitTime);
+  double backgroundTime(wStatus.t_total);
+  long totalBytesWritten(wStatus.nbytes);
+
+  ParallelDescriptor::ReduceRealMax(syncTime, ioProc);
+  ParallelDescriptor::ReduceRealMax(callTime, ioProc);
+  ParallelDescriptor::ReduceRealMax(waitTime, ioProc);
+  ParallelDescriptor::ReduceRealMax(exposedTime, ioProc);
+  ParallelDescriptor::ReduceRealMax(backgroundTime, ioProc);
+  ParallelDescriptor::ReduceLongSum(totalBytesWritten, ioProc);
+  Real megabytes((static_cast<Real> (totalBytesWritten)) / bytesPerMB);
+
+  if(ParallelDescriptor::IOProcessor()) {
+    cout << std::setprecision(5);
+    cout << "------------------------------------------" << endl;
+    cout << "  Levels                = " << nLevels << endl;
+    cout << "  Total megabytes       = " << megabytes << endl;
+    cout << "  Simulated work time   = " << workTime << " s." << endl;
+    cout << "  Sync write time       = " << syncTime << " s." << endl;
+    cout << "  Async call time       = " << callTime << " s." << endl;
+    cout << "  Async wait time       = " << waitTime << " s." << endl;
+    cout << "  Async exposed time    = " << exposedTime << " s." << endl;
+    cout << "  Async background time = " << backgroundTime << " s." << endl;
+    cout << "------------------------------------------" << endl;
+  }
+}
+
+
+// -------------------------------------------------------------
+// Write a MultiFab with the Compressed_v1 header version and the
+// given codec, read it back, and report the compression ratio, the
+// write and read throughput of the uncompressed data, and the largest
+// difference between the data written and read.
+// -------------------------------------------------------------
+void TestCompression(int nfiles, int maxgrid, int ncomps, int nboxes,
+                     bool raninit, bool mb2, const std::string &codec,
+                     const std::string &dirName)
+{
+  VisMF::SetNOutFiles(nfiles);
+  if(mb2) {
+    bytesPerMB = pow(2.0, 20);
+  }
+
+  BoxArray bArray(MakeBoxArray(maxgrid, nboxes));
+  DistributionMapping dmap{bArray};
+  MultiFab mf(bArray, dmap, ncomps, 0);
+
+  for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+    FArrayBox &fab = mf[mfi];
+    const Box &bx = fab.box();
+    for(int invar(0); invar < ncomps; ++invar) {
+      for(IntVect iv(bx.smallEnd()); iv <= bx.bigEnd(); bx.next(iv)) {
+        if(raninit) {
+          fab(iv, invar) = amrex::Random() + (1.0 + static_cast<Real> (invar));
+        } else {  // ---- smooth data
+          Real val(1.0 + invar);
+          for(int d(0); d < BL_SPACEDIM; ++d) {
+            val *= std::cos(0.05 * (invar + 1) * iv[d]);
+          }
+          fab(iv, invar) = val;
+        }
+      }
+    }
+  }
+
+  std::string mfName(dirName.empty() ? "TestMFCompressed" : dirName + "/TestMFCompressed");
+  VisMF::RemoveFiles(mfName, false);  // ---- not verbose
+
+  VisMF::Header::Version currentVersion(VisMF::GetHeaderVersion());
+  std::string currentCompression(VisMF::GetCompression());
+  VisMF::SetHeaderVersion(VisMF::Header::Compressed_v1);
+  VisMF::SetCompression(codec);
+
+  ParallelDescriptor::Barrier("TestCompression:BeforeWrite");
+  double writeTime(ParallelDescriptor::second());
+  long totalBytesWritten(VisMF::Write(mf, mfName));
+  writeTime = ParallelDescriptor::second() - writeTime;
+
+  MultiFab mfRead(bArray, dmap, ncomps, 0);
+  VisMF::CloseAllStreams();
+  ParallelDescriptor::Barrier("TestCompression:BeforeRead");
+  double readTime(ParallelDescriptor::second());
+  VisMF::Read(mfRead, mfName);
+  readTime = ParallelDescriptor::second() - readTime;
+
+  MultiFab::Subtract(mfRead, mf, 0, 0, ncomps, 0);
+  Real maxError(0.0);
+  for(int invar(0); invar < ncomps; ++invar) {
+    maxError = std::max(maxError, mfRead.norm0(invar));
+  }
+
+  long totalBytes(0);
+  for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+    totalBytes += mf[mfi].nBytes();
+  }
+
+  int ioProc(ParallelDescriptor::IOProcessorNumber());
+  ParallelDescriptor::ReduceLongSum(totalBytesWritten, ioProc);
+  ParallelDescriptor::ReduceLongSum(totalBytes, ioProc);
+  ParallelDescriptor::ReduceRealMax(writeTime, ioProc);
+  ParallelDescriptor::ReduceRealMax(readTime, ioProc);
+  Real megabytes((static_cast<Real> (totalBytes)) / bytesPerMB);
+  Real megabytesWritten((static_cast<Real> (totalBytesWritten)) / bytesPerMB);
+
+  if(ParallelDescriptor::IOProcessor()) {
+    cout << std::setprecision(5);
+    cout << "------------------------------------------" << endl;
+    cout << "  Codec                 = " << codec << endl;
+    cout << "  Data megabytes        = " << megabytes << endl;
+    cout << "  Written megabytes     = " << megabytesWritten << endl;
+    cout << "  Compression ratio     = " << megabytes/megabytesWritten << endl;
+    cout << "  Write:  Megabytes/sec = " << megabytes/writeTime << endl;
+    cout << "  Read:   Megabytes/sec = " << megabytes/readTime << endl;
+    cout << "  Write time            = " << writeTime << " s." << endl;
+    cout << "  Read time             = " << readTime << " s." << endl;
+    cout << "  Max error             = " << maxError << endl;
+    cout << "------------------------------------------" << endl;
+  }
+
+  VisMF::SetHeaderVersion(currentVersion);  // ---- set back to previous version
+  VisMF::SetCompression(currentCompression);
+}
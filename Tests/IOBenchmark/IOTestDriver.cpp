@@ -34,6 +34,12 @@ void TestWriteNFiles(int nfiles, int maxgrid, int ncomps, int nboxes,
 		     const std::string &dirName);
 void TestReadMF(const std::string &mfName, bool useSyncReads,
                      int nMultiFabs, const std::string &dirName);
+void TestWriteAsyncPlotfile(int nfiles, int maxgrid, int ncomps, int nboxes,
+                            int nLevels, double workTime, bool mb2,
+                            const std::string &dirName);
+void TestCompression(int nfiles, int maxgrid, int ncomps, int nboxes,
+                     bool raninit, bool mb2, const std::string &codec,
+                     const std::string &dirName);
 void NFileTests(int nOutFiles, const std::string &filePrefix);
 void DSSNFileTests(int nOutFiles, const std::string &filePrefix,
                    bool useIter);
@@ -73,6 +79,9 @@ static void PrintUsage(const char *progName) {
     cout << "   [usesyncreads      = tf       ]" << '\n';
     cout << "   [nmultifabs        = nmf      ]" << '\n';
     cout << "   [dirname           = dirname  ]" << '\n';
+    cout << "   [testasyncplotfile = tf       ]" << '\n';
+    cout << "   [asyncworktime     = seconds  ]" << '\n';
+    cout << "   [testcompression   = codecs   ]" << '\n';
     cout << '\n';
 }
 
@@ -107,6 +116,9 @@ int main(int argc, char *argv[]) {
   Vector<std::string> readFANames;
   int nReadStreams(1), nMultiFabs(1);
   std::string dirName("");
+  bool testasyncplotfile(false);
+  double asyncWorkTime(1.0);
+  Vector<std::string> testCompressionCodecs;
 
 
   pp.query("nfiles", nfiles);
@@ -161,6 +173,12 @@ int main(int argc, char *argv[]) {
   pp.query("nreadstreams", nReadStreams);
   nReadStreams = std::max(1, nReadStreams);
   pp.query("dirname", dirName);
+  pp.query("testasyncplotfile", testasyncplotfile);
+  pp.query("asyncworktime", asyncWorkTime);
+  int nCodecs(pp.countval("testcompression"));
+  if(nCodecs > 0) {
+    pp.getarr("testcompression", testCompressionCodecs, 0, nCodecs);
+  }
 
 
   if(ParallelDescriptor::IOProcessor()) {
@@ -198,6 +216,11 @@ int main(int argc, char *argv[]) {
     cout << "usedss            = " << useDSS << '\n';
     cout << "usesyncreads      = " << useSyncReads << '\n';
     cout << "nmultifabs        = " << nMultiFabs << '\n';
+    cout << "testasyncplotfile = " << testasyncplotfile << '\n';
+    cout << "asyncworktime     = " << asyncWorkTime << '\n';
+    for(int i(0); i < testCompressionCodecs.size(); ++i) {
+      cout << "testCompressionCodecs[" << i << "]    = " << testCompressionCodecs[i] << '\n';
+    }
     cout << "dirName           = " << dirName << '\n';
 
     cout << '\n';
@@ -483,6 +506,55 @@ int main(int argc, char *argv[]) {
 
 
 
+  if(testasyncplotfile) {
+    for(int itimes(0); itimes < ntimes; ++itimes) {
+      ParallelDescriptor::Barrier("TestWriteAsyncPlotfile::BeforeSleep2");
+      amrex::USleep(2);
+      ParallelDescriptor::Barrier("TestWriteAsyncPlotfile::AfterSleep2");
+
+      if(ParallelDescriptor::IOProcessor()) {
+        cout << endl << "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~" << endl;
+        cout << "Testing Async Plotfile Write" << endl;
+      }
+
+      TestWriteAsyncPlotfile(nfiles, maxgrid, ncomps, nboxes, nMultiFabs,
+                             asyncWorkTime, mb2, dirName);
+
+      ParallelDescriptor::Barrier("TestWriteAsyncPlotfile::finished");
+
+      if(ParallelDescriptor::IOProcessor()) {
+        cout << "==================================================" << endl;
+        cout << endl;
+      }
+    }
+  }
+
+
+  for(int c(0); c < testCompressionCodecs.size(); ++c) {
+    for(int itimes(0); itimes < ntimes; ++itimes) {
+      ParallelDescriptor::Barrier("TestCompression::BeforeSleep2");
+      amrex::USleep(2);
+      ParallelDescriptor::Barrier("TestCompression::AfterSleep2");
+
+      if(ParallelDescriptor::IOProcessor()) {
+        cout << endl << "++++++++++++++++++++++++++++++++++++++++++++++++++" << endl;
+        cout << "Testing Compressed Write:  codec = " << testCompressionCodecs[c] << endl;
+      }
+
+      TestCompression(nfiles, maxgrid, ncomps, nboxes, raninit, mb2,
+                      testCompressionCodecs[c], dirName);
+
+      ParallelDescriptor::Barrier("TestCompression::finished");
+
+      if(ParallelDescriptor::IOProcessor()) {
+        cout << "==================================================" << endl;
+        cout << endl;
+      }
+    }
+  }
+
+
+
   amrex::Finalize();
   return 0;
 }
@@ -6,6 +6,8 @@
 
 #include <prob_par.H>
 
+#include <functional>
+
 using namespace amrex;
 
 namespace {
@@ -20,6 +22,35 @@ static int linop_maxorder = 2;
 static bool agglomeration = false;
 static bool consolidation = false;
 static int  use_hypre = 0;
+static std::string bottom_solver;
+static int  bottom_sstep = 4;
+static int  single_precision_level = -1;
+static std::string smoother;
+static int  chebyshev_degree = 2;
+static int  smoother_ghost_depth = 1;
+static int  num_solves = 1;
+
+void set_bottom_solver (MLMG& mlmg)
+{
+    if (use_hypre) {
+        mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
+    } else if (bottom_solver == "bicgstab") {
+        mlmg.setBottomSolver(MLMG::BottomSolver::bicgstab);
+    } else if (bottom_solver == "cg") {
+        mlmg.setBottomSolver(MLMG::BottomSolver::cg);
+    } else if (bottom_solver == "pipelined_bicgstab") {
+        mlmg.setBottomSolver(MLMG::BottomSolver::pipelined_bicgstab);
+    } else if (bottom_solver == "pipelined_cg") {
+        mlmg.setBottomSolver(MLMG::BottomSolver::pipelined_cg);
+    } else if (bottom_solver == "sstep_cg") {
+        mlmg.setBottomSolver(MLMG::BottomSolver::sstep_cg);
+        mlmg.setBottomSStep(bottom_sstep);
+    } else if (!bottom_solver.empty()) {
+        amrex::Abort("Unknown bottom_solver " + bottom_solver);
+    }
+    mlmg.setSinglePrecisionLevel(single_precision_level);
+    mlmg.setSmootherGhostDepth(smoother_ghost_depth);
+}
 }
 
 void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
@@ -44,6 +75,13 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
     pp.query("agglomeration", agglomeration);
     pp.query("consolidation", consolidation);
     pp.query("use_hypre", use_hypre);
+    pp.query("bottom_solver", bottom_solver);
+    pp.query("bottom_sstep", bottom_sstep);
+    pp.query("single_precision_level", single_precision_level);
+    pp.query("smoother", smoother);
+    pp.query("chebyshev_degree", chebyshev_degree);
+    pp.query("smoother_ghost_depth", smoother_ghost_depth);
+    pp.query("num_solves", num_solves);
     pp.query("tol_rel", tol_rel);
     pp.query("tol_abs", tol_abs);
   }
@@ -52,6 +90,11 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
   info.setAgglomeration(agglomeration);
   info.setConsolidation(consolidation);
   info.setMaxCoarseningLevel(max_coarsening_level);
+  if (smoother == "chebyshev") {
+      info.setSmoother(Smoother::chebyshev).setChebyshevDegree(chebyshev_degree);
+  } else if (!smoother.empty()) {
+      amrex::Abort("Unknown smoother " + smoother);
+  }
 
   const int nlevels = geom.size();
 
@@ -67,36 +110,160 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
       prhs.push_back(&(rhs[ilev]));
     }
 
-    MLABecLaplacian mlabec(geom, grids, dmap, info);
-    mlabec.setMaxOrder(linop_maxorder);
-    // BC
-    mlabec.setDomainBC({prob::bc_type, prob::bc_type, prob::bc_type},
-                       {prob::bc_type, prob::bc_type, prob::bc_type});
-    for (int ilev = 0; ilev < nlevels; ++ilev) {
-      mlabec.setLevelBC(ilev, psoln[ilev]);
-    }
-    mlabec.setScalars(prob::a, prob::b);
-    for (int ilev = 0; ilev < nlevels; ++ilev) {
-      mlabec.setACoeffs(ilev, alpha[ilev]);
-      std::array<MultiFab, AMREX_SPACEDIM> bcoefs;
-      for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-        const BoxArray& ba = amrex::convert(beta[ilev].boxArray(),
-                                            IntVect::TheDimensionVector(idim));
-        bcoefs[idim].define(ba, beta[ilev].DistributionMap(), 1, 0);
+    // alpha_fine is the alpha of the finest level, which is changed
+    // between the solves.
+    auto setup_linop = [&] (MLABecLaplacian& mlabec, const Vector<MultiFab*>& bcsoln,
+                            const MultiFab& alpha_fine) {
+      mlabec.setMaxOrder(linop_maxorder);
+      // BC
+      mlabec.setDomainBC({prob::bc_type, prob::bc_type, prob::bc_type},
+                         {prob::bc_type, prob::bc_type, prob::bc_type});
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        mlabec.setLevelBC(ilev, bcsoln[ilev]);
       }
-      amrex::average_cellcenter_to_face(amrex::GetArrOfPtrs(bcoefs),
-                                        beta[ilev], geom[ilev]);
-      mlabec.setBCoeffs(ilev, amrex::GetArrOfConstPtrs(bcoefs));
-    }
+      mlabec.setScalars(prob::a, prob::b);
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        mlabec.setACoeffs(ilev, (ilev == nlevels-1) ? alpha_fine : alpha[ilev]);
+        std::array<MultiFab, AMREX_SPACEDIM> bcoefs;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+          const BoxArray& ba = amrex::convert(beta[ilev].boxArray(),
+                                              IntVect::TheDimensionVector(idim));
+          bcoefs[idim].define(ba, beta[ilev].DistributionMap(), 1, 0);
+        }
+        amrex::average_cellcenter_to_face(amrex::GetArrOfPtrs(bcoefs),
+                                          beta[ilev], geom[ilev]);
+        mlabec.setBCoeffs(ilev, amrex::GetArrOfConstPtrs(bcoefs));
+      }
+    };
+
+    auto setup_mlmg = [&] (MLMG& mlmg) {
+      mlmg.setMaxIter(max_iter);
+      mlmg.setMaxFmgIter(max_fmg_iter);
+      set_bottom_solver(mlmg);
+      mlmg.setVerbose(verbose);
+      mlmg.setBottomVerbose(cg_verbose);
+    };
+
+    MultiFab alpha_fine(alpha[nlevels-1].boxArray(), alpha[nlevels-1].DistributionMap(), 1, 0);
+    MultiFab::Copy(alpha_fine, alpha[nlevels-1], 0, 0, 1, 0);
+
+    MLABecLaplacian mlabec(geom, grids, dmap, info);
+    setup_linop(mlabec, psoln, alpha_fine);
 
     MLMG mlmg(mlabec);
-    mlmg.setMaxIter(max_iter);
-    mlmg.setMaxFmgIter(max_fmg_iter);
-    if (use_hypre) mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
-    mlmg.setVerbose(verbose);
-    mlmg.setBottomVerbose(cg_verbose);
+    setup_mlmg(mlmg);
+
+    // Solves from zero with a new linear operator and MLMG, set up like the
+    // ones above and then changed by modify, into soln_new.  Returns the
+    // number of iterations, and the number of halo exchanges in nhalo.
+    auto solve_new = [&] (Vector<MultiFab>& soln_new, const std::function<void(MLMG&)>& modify,
+                          Long& nhalo) {
+      soln_new.resize(nlevels);
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        soln_new[ilev].define(grids[ilev], dmap[ilev], 1, soln[ilev].nGrow());
+        soln_new[ilev].setVal(0.0);
+      }
+
+      MLABecLaplacian mlabec_new(geom, grids, dmap, info);
+      setup_linop(mlabec_new, amrex::GetVecOfPtrs(soln_new), alpha_fine);
+
+      MLMG mlmg_new(mlabec_new);
+      setup_mlmg(mlmg_new);
+      mlmg_new.setVerbose(0);
+      modify(mlmg_new);
 
-    mlmg.solve(psoln, prhs, tol_rel, tol_abs);
+      const Long nhalo0 = mlabec_new.numHaloExchanges();
+      mlmg_new.solve(amrex::GetVecOfPtrs(soln_new), prhs, tol_rel, tol_abs);
+      nhalo = mlabec_new.numHaloExchanges() - nhalo0;
+      return mlmg_new.getNumIters();
+    };
+
+    // The max norm of soln_new - soln, and of soln.
+    auto compare = [&] (Vector<MultiFab>& soln_new, Real& diff, Real& norm) {
+      diff = 0.0;
+      norm = 0.0;
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        MultiFab::Subtract(soln_new[ilev], soln[ilev], 0, 0, 1, 0);
+        diff = std::max(diff, soln_new[ilev].norm0());
+        norm = std::max(norm, soln[ilev].norm0());
+      }
+    };
+
+    // Set up once and solve num_solves times, changing the coefficients
+    // of the finest level in between as a time stepping code would.  Each
+    // of those solves is checked against a solver built from scratch with
+    // the same coefficients.
+    mlmg.prepare(psoln, prhs);
+    for (int isolve = 0; isolve < num_solves; ++isolve) {
+      if (isolve > 0) {
+        MultiFab::Copy(alpha_fine, alpha[nlevels-1], 0, 0, 1, 0);
+        alpha_fine.mult(std::pow(100.0, isolve));
+        mlabec.setACoeffs(nlevels-1, alpha_fine);
+        for (auto* p : psoln) {
+          p->setVal(0.0);
+        }
+      }
+      const Long nhalo0 = mlabec.numHaloExchanges();
+      mlmg.solve(psoln, prhs, tol_rel, tol_abs);
+      const Long nhalo = mlabec.numHaloExchanges() - nhalo0;
+
+      // Single precision is only used for the corrections below the top
+      // of each V-cycle, so it should cost at most one more iteration than
+      // all in double precision, for V-cycles and F-cycles alike.
+      if (isolve == 0 && single_precision_level >= 0) {
+        Vector<MultiFab> soln_dp;
+        Long nhalo_dp;
+        const int iters_dp = solve_new(soln_dp, [] (MLMG& m) { m.setSinglePrecisionLevel(-1); },
+                                       nhalo_dp);
+        Real diff, norm;
+        compare(soln_dp, diff, norm);
+        amrex::Print() << "Single precision from MG level " << single_precision_level << ": "
+                       << mlmg.getNumIters() << " iterations, " << iters_dp
+                       << " in double precision, max difference " << diff
+                       << " relative to max " << norm << "\n";
+        if (mlmg.getNumIters() > iters_dp + 1) {
+          amrex::Abort("solve_with_mlmg: single precision MG levels take too many iterations");
+        }
+      }
+
+      // Deeper ghost cells trade halo exchanges for redundant smoothing in
+      // the ghost cells, which gives the same V-cycles.  F-cycles can
+      // differ at roundoff level.
+      if (isolve == 0 && smoother_ghost_depth > 1) {
+        Vector<MultiFab> soln_d1;
+        Long nhalo_d1;
+        const int iters_d1 = solve_new(soln_d1, [] (MLMG& m) { m.setSmootherGhostDepth(1); },
+                                       nhalo_d1);
+        Real diff, norm;
+        compare(soln_d1, diff, norm);
+        amrex::Print() << "Smoother ghost depth " << smoother_ghost_depth << ": "
+                       << mlmg.getNumIters() << " iterations and " << nhalo
+                       << " halo exchanges, " << iters_d1 << " and " << nhalo_d1
+                       << " with depth 1, max difference " << diff
+                       << " relative to max " << norm << "\n";
+        if (mlmg.getNumIters() != iters_d1 || diff > 1.e-12*norm) {
+          amrex::Abort("solve_with_mlmg: deep ghost cell smoothing changes the solve");
+        }
+        // The single precision MG levels are always smoothed with depth 1.
+        if (single_precision_level < 0 && nhalo >= nhalo_d1) {
+          amrex::Abort("solve_with_mlmg: deep ghost cell smoothing does not save halo exchanges");
+        }
+      }
+
+      if (isolve > 0) {
+        Vector<MultiFab> soln_new;
+        Long nhalo_new;
+        const int iters_new = solve_new(soln_new, [] (MLMG&) {}, nhalo_new);
+        Real diff, norm;
+        compare(soln_new, diff, norm);
+        amrex::Print() << "Solve " << isolve << ": " << mlmg.getNumIters() << " iterations, "
+                       << iters_new << " with a new MLMG, max difference "
+                       << diff << " relative to max " << norm << "\n";
+        if (mlmg.getNumIters() != iters_new || diff > 1.e-12*norm) {
+          amrex::Abort("solve_with_mlmg: the reused MLMG does not match a new one");
+        }
+      }
+    }
   } else {
     const int levbegin = (fine_leve_solve_only) ? nlevels-1 : 0;
     for (int ilev = 0; ilev < levbegin; ++ilev) {
@@ -135,6 +302,7 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
       MLMG mlmg(mlabec);
       mlmg.setMaxIter(max_iter);
       mlmg.setMaxFmgIter(max_fmg_iter);
+      set_bottom_solver(mlmg);
       mlmg.setVerbose(verbose);
       mlmg.setBottomVerbose(cg_verbose);
 
@@ -0,0 +1,246 @@
+#include <AMReX.H>
+#include <AMReX_iMultiFab.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace amrex;
+
+namespace {
+
+struct TestParams
+{
+    int n_cell = 60;
+    int max_grid_size = 24;
+    IntVect tile_size{AMREX_D_DECL(8,4,16)};
+};
+
+TestParams get_test_params ()
+{
+    TestParams params;
+    ParmParse pp;
+    pp.query("n_cell", params.n_cell);
+    pp.query("max_grid_size", params.max_grid_size);
+    Vector<int> ts;
+    if (pp.queryarr("tile_size", ts)) {
+        params.tile_size = IntVect(ts);
+    }
+    return params;
+}
+
+// The core box and the rim boxes of every tile must be disjoint, cover the
+// tile box, and be on the right side of the valid box shrunk by nghost.
+void testCoreRim (const BoxArray& ba, const DistributionMapping& dm,
+                  const IntVect& tile_size, const IntVect& nghost)
+{
+    MultiFab mf(ba, dm, 1, nghost);
+
+    long ntiles = 0;
+    long npts = 0;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:ntiles,npts)
+#endif
+    for (MFIter mfi(mf, MFItInfo().EnableTiling(tile_size)); mfi.isValid(); ++mfi)
+    {
+        const Box& tbx = mfi.tilebox();
+        const Box& inner = amrex::grow(mfi.validbox(), -nghost);
+        const Box& core = mfi.coretilebox(nghost);
+        const BoxList& rims = mfi.rimtileboxes(nghost);
+
+        BoxList all = rims;
+        if (core.ok()) {
+            if (!tbx.contains(core) || !inner.contains(core)) {
+                amrex::Abort("testCoreRim: the core box is not inside the tile and the inner valid box");
+            }
+            all.push_back(core);
+        }
+
+        long n = 0;
+        for (const Box& b : rims) {
+            if (!b.ok() || !tbx.contains(b)) {
+                amrex::Abort("testCoreRim: a rim box is empty or not inside the tile");
+            }
+            if (b.intersects(inner)) {
+                amrex::Abort("testCoreRim: a rim box does not need ghost cells");
+            }
+        }
+        for (const Box& b : all) {
+            n += b.numPts();
+        }
+        if (n != tbx.numPts() || !all.isDisjoint()) {
+            amrex::Abort("testCoreRim: the core and rim boxes do not partition the tile");
+        }
+
+        ++ntiles;
+        npts += tbx.numPts();
+    }
+
+    ParallelDescriptor::ReduceLongSum(npts);
+    ParallelDescriptor::ReduceLongSum(ntiles);
+    if (npts != ba.numPts()) {
+        amrex::Abort("testCoreRim: the tiles do not cover the BoxArray");
+    }
+
+    amrex::Print() << "testCoreRim: " << (ba.ixType().cellCentered() ? "cell-centered" : "nodal") << " boxes, nghost " << nghost
+                   << ": core and rim boxes partition all " << ntiles << " tiles\n";
+}
+
+// With work stealing, every tile is visited by exactly one thread, even
+// when the work per tile is very uneven.
+void testWorkStealing (const BoxArray& ba, const DistributionMapping& dm, const IntVect& tile_size)
+{
+    iMultiFab visits(ba, dm, 1, 0);
+    visits.setVal(0);
+
+    // The cost estimate is the opposite of the real cost, so that the
+    // threads with the cheap tiles run out early and steal.
+    LayoutData<Real> cost(ba, dm);
+    for (MFIter mfi(cost); mfi.isValid(); ++mfi) {
+        cost[mfi] = (mfi.index() % 2 == 0) ? 1.0 : 10.0;
+    }
+
+    MFIter::resetWorkStealingStats();
+
+    const int nloops = 4;
+    long ntiles = 0;
+    double sum = 0.0;
+    for (int iloop = 0; iloop < nloops; ++iloop)
+    {
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:ntiles,sum)
+#endif
+        for (MFIter mfi(visits, MFItInfo().EnableTiling(tile_size).SetWorkStealing(true,&cost));
+             mfi.isValid(); ++mfi)
+        {
+            const Box& tbx = mfi.tilebox();
+            Array4<int> const& v = visits.array(mfi);
+            amrex::LoopOnCpu(tbx, [=] (int i, int j, int k) noexcept { ++v(i,j,k); });
+            const int nwork = (mfi.index() % 2 == 0) ? 20000 : 10;
+            for (int n = 0; n < nwork; ++n) {
+                sum += std::sqrt(double(n));
+            }
+            ++ntiles;
+        }
+    }
+
+    ParallelDescriptor::ReduceLongSum(ntiles);
+    if (visits.min(0) != nloops || visits.max(0) != nloops) {
+        amrex::Abort("testWorkStealing: a cell was not visited exactly once per loop");
+    }
+
+    const MFIter::WorkStealingStats stats = MFIter::workStealingStats();
+#ifdef _OPENMP
+    if (omp_get_max_threads() > 1 && stats.loops != nloops) {
+        amrex::Abort("testWorkStealing: the work stealing loops were not counted");
+    }
+#endif
+
+    amrex::Print() << "testWorkStealing: " << ntiles/nloops << " tiles visited once in each of "
+                   << nloops << " loops, " << stats.steals << " steals on process 0"
+                   << " (checksum " << sum << ")\n";
+}
+
+// Run the tuned loop until the tuning is done, checking that every loop
+// covers the BoxArray.
+void runTuned (const MultiFab& mf, const std::string& region)
+{
+    const int nloops = FabArrayBase::tile_tune_candidates.size()*FabArrayBase::tile_tune_trials + 1;
+    for (int iloop = 0; iloop < nloops; ++iloop)
+    {
+        long npts = 0;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:npts)
+#endif
+        for (MFIter mfi(mf, MFItInfo().EnableTileTuning(region)); mfi.isValid(); ++mfi)
+        {
+            npts += mfi.tilebox().numPts();
+        }
+        ParallelDescriptor::ReduceLongSum(npts);
+        if (npts != mf.boxArray().numPts()) {
+            amrex::Abort("runTuned: the tiles do not cover the BoxArray");
+        }
+    }
+}
+
+// BoxArrays whose first boxes have the same size, but not the same box
+// sizes, are tuned separately.
+void testTileTuneKey (int max_grid_size)
+{
+    const std::string tune_file = "mfitertiles_tile_tune.txt";
+    if (ParallelDescriptor::IOProcessor()) {
+        std::remove(tune_file.c_str());
+    }
+    ParallelDescriptor::Barrier();
+
+    FabArrayBase::tile_tune_file = tune_file;
+    FabArrayBase::tile_tune_trials = 1;
+    FabArrayBase::tile_tune_candidates = {IntVect(AMREX_D_DECL(1024,4,4)), IntVect(8)};
+
+    // One size only, and the same boxes plus a thinner one at the end.
+    BoxArray ba_one(Box(IntVect(0), IntVect(2*max_grid_size-1)));
+    ba_one.maxSize(max_grid_size);
+    BoxList bl = ba_one.boxList();
+    bl.push_back(Box(IntVect(AMREX_D_DECL(2*max_grid_size,0,0)),
+                     IntVect(AMREX_D_DECL(2*max_grid_size+max_grid_size/2-1,
+                                          max_grid_size-1, max_grid_size-1))));
+    BoxArray ba_two(std::move(bl));
+
+    MultiFab mf_one(ba_one, DistributionMapping(ba_one), 1, 0);
+    MultiFab mf_two(ba_two, DistributionMapping(ba_two), 1, 0);
+    runTuned(mf_one, "tile tune");
+    runTuned(mf_two, "tile tune");
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::ifstream ifs(tune_file);
+        std::string line;
+        Vector<std::string> keys;
+        while (std::getline(ifs, line)) {
+            keys.push_back(line.substr(0, line.find(' ')));
+            amrex::Print() << "testTileTuneKey: " << line << "\n";
+        }
+        if (keys.size() != 2 || keys[0] == keys[1]) {
+            amrex::Abort("testTileTuneKey: expected one tuning per set of box sizes");
+        }
+        if (keys[0].find(',') != std::string::npos || keys[1].find(',') == std::string::npos) {
+            amrex::Abort("testTileTuneKey: the key does not list every box size");
+        }
+        std::remove(tune_file.c_str());
+    }
+
+    FabArrayBase::tile_tune_file.clear();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        const TestParams params = get_test_params();
+
+        const Box domain(IntVect(0), IntVect(params.n_cell-1));
+        BoxArray ba(domain);
+        ba.maxSize(params.max_grid_size);
+        DistributionMapping dm(ba);
+
+        for (const IntVect& nghost : {IntVect(0), IntVect(1), IntVect(AMREX_D_DECL(1,2,3)),
+                                      IntVect(params.max_grid_size)})
+        {
+            testCoreRim(ba, dm, params.tile_size, nghost);
+            testCoreRim(amrex::convert(ba, IntVect::TheNodeVector()), dm, params.tile_size, nghost);
+        }
+
+        testWorkStealing(ba, dm, params.tile_size);
+        testTileTuneKey(params.max_grid_size);
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,325 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+#include <AMReX_DenseBins.H>
+#include <AMReX_NeighborList.H>
+
+#include <algorithm>
+#include <random>
+
+using namespace amrex;
+
+using PC = ParticleContainer<0>;
+
+struct TestParams
+{
+    IntVect size;
+    int max_grid_size;
+    int num_ppc;
+};
+
+// An item of the bins is simply the cell it is in, relative to the Box of the bins.
+struct Item
+{
+    IntVect cell;
+};
+
+struct ItemCell
+{
+    AMREX_GPU_HOST_DEVICE
+    IntVect operator() (const Item& item) const noexcept { return item.cell; }
+};
+
+// The inverse of the bin index of DenseBins.
+IntVect binCell (int bin, const Box& bx)
+{
+    const IntVect len = bx.length();
+    IntVect iv;
+#if (AMREX_SPACEDIM == 3)
+    iv[2] = bin % len[2];  bin /= len[2];
+#endif
+#if (AMREX_SPACEDIM >= 2)
+    iv[1] = bin % len[1];  bin /= len[1];
+#endif
+    iv[0] = bin;
+    return iv;
+}
+
+// Check that a and b have the same offsets and the same set of items in each
+// bin, and that each item is in the right bin.  The order of the items
+// within a bin may differ.
+template <class T, class F>
+void checkSameBins (const DenseBins<T>& a, const DenseBins<T>& b, const Box& bx, F cell_of)
+{
+    AMREX_ALWAYS_ASSERT(a.numItems() == b.numItems());
+    AMREX_ALWAYS_ASSERT(a.numBins() == b.numBins());
+    const auto aoff = a.offsetsPtr();
+    const auto boff = b.offsetsPtr();
+    const auto aperm = a.permutationPtr();
+    const auto bperm = b.permutationPtr();
+    for (int bin = 0; bin < a.numBins(); ++bin)
+    {
+        AMREX_ALWAYS_ASSERT(aoff[bin] == boff[bin] && aoff[bin+1] == boff[bin+1]);
+        std::vector<unsigned int> ia(aperm + aoff[bin], aperm + aoff[bin+1]);
+        std::vector<unsigned int> ib(bperm + boff[bin], bperm + boff[bin+1]);
+        std::sort(ia.begin(), ia.end());
+        std::sort(ib.begin(), ib.end());
+        AMREX_ALWAYS_ASSERT(ia == ib);
+        for (auto i : ia) {
+            AMREX_ALWAYS_ASSERT(cell_of(i) == binCell(bin, bx));
+        }
+    }
+}
+
+Item randomItem (const Box& bx, std::mt19937& gen)
+{
+    const IntVect len = bx.length();
+    Item item;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        item.cell[d] = std::uniform_int_distribution<int>(0, len[d]-1)(gen);
+    }
+    return item;
+}
+
+// Move every stride-th item to a random cell, and return how many changed cells.
+int moveItems (std::vector<Item>& items, int stride, const Box& bx, std::mt19937& gen)
+{
+    int nmoved = 0;
+    for (int i = 0; i < static_cast<int>(items.size()); i += stride) {
+        const Item old = items[i];
+        items[i] = randomItem(bx, gen);
+        if (items[i].cell != old.cell) ++nmoved;
+    }
+    return nmoved;
+}
+
+// DenseBins::update against DenseBins::build on the same items.
+void testUpdate ()
+{
+    // The bins are over a Box that does not start at the origin; the cells are relative to it.
+    const Box bx(IntVect(AMREX_D_DECL(8,4,16)), IntVect(AMREX_D_DECL(15,15,23)));
+    std::mt19937 gen(451);
+
+    std::vector<Item> items(4*bx.numPts());
+    for (auto& item : items) item = randomItem(bx, gen);
+    auto cell_of = [&] (unsigned int i) { return items[i].cell; };
+
+    DenseBins<Item> bins;
+    bins.build(items.size(), items.data(), bx, ItemCell());
+    DenseBins<Item> ref;
+
+    // Nothing moved.  The permutation must stay as it is.
+    std::vector<unsigned int> perm(bins.permutationPtr(), bins.permutationPtr() + bins.numItems());
+    AMREX_ALWAYS_ASSERT(bins.update(items.size(), items.data(), bx, ItemCell()) == 0);
+    AMREX_ALWAYS_ASSERT(std::equal(perm.begin(), perm.end(), bins.permutationPtr()));
+
+    // A few items moved, with the same number of items.
+    int nmoved = moveItems(items, 7, bx, gen);
+    AMREX_ALWAYS_ASSERT(bins.update(items.size(), items.data(), bx, ItemCell()) == size_t(nmoved));
+    ref.build(items.size(), items.data(), bx, ItemCell());
+    checkSameBins(bins, ref, bx, cell_of);
+
+    // Again, starting from the order of the last update.
+    nmoved = moveItems(items, 5, bx, gen);
+    AMREX_ALWAYS_ASSERT(bins.update(items.size(), items.data(), bx, ItemCell()) == size_t(nmoved));
+    ref.build(items.size(), items.data(), bx, ItemCell());
+    checkSameBins(bins, ref, bx, cell_of);
+
+    // Gather the items into bin-sorted order, as SortParticlesByCell does,
+    // then add some items and move a few.
+    {
+        std::vector<Item> sorted(items.size());
+        for (std::size_t k = 0; k < items.size(); ++k) sorted[k] = items[bins.permutationPtr()[k]];
+        items.swap(sorted);
+        bins.setSortedItems(items.data());
+    }
+    const std::size_t nold = items.size();
+    for (int i = 0; i < 100; ++i) items.push_back(randomItem(bx, gen));
+    moveItems(items, 11, bx, gen);
+    AMREX_ALWAYS_ASSERT(bins.update(items.size(), items.data(), bx, ItemCell()) < nold);
+    ref.build(items.size(), items.data(), bx, ItemCell());
+    checkSameBins(bins, ref, bx, cell_of);
+
+    // Gather again, then remove some items and move a few.
+    {
+        std::vector<Item> sorted(items.size());
+        for (std::size_t k = 0; k < items.size(); ++k) sorted[k] = items[bins.permutationPtr()[k]];
+        items.swap(sorted);
+        bins.setSortedItems(items.data());
+    }
+    items.resize(items.size() - 300);
+    moveItems(items, 13, bx, gen);
+    bins.update(items.size(), items.data(), bx, ItemCell());
+    ref.build(items.size(), items.data(), bx, ItemCell());
+    checkSameBins(bins, ref, bx, cell_of);
+
+    // Most items moved.  This falls back to build.
+    moveItems(items, 1, bx, gen);
+    AMREX_ALWAYS_ASSERT(bins.update(items.size(), items.data(), bx, ItemCell()) == items.size());
+    ref.build(items.size(), items.data(), bx, ItemCell());
+    checkSameBins(bins, ref, bx, cell_of);
+
+    amrex::Print() << "DenseBins::update matches DenseBins::build\n";
+}
+
+// Check that the particles of each tile are in the cells of their bins.
+void checkCellSorted (const PC& pc)
+{
+    const int lev = 0;
+    const auto plo = pc.Geom(lev).ProbLoArray();
+    const auto dxi = pc.Geom(lev).InvCellSizeArray();
+    const Box domain = pc.Geom(lev).Domain();
+
+    for (PC::ParConstIterType pti(pc, lev); pti.isValid(); ++pti)
+    {
+        const Box& tbx = pti.tilebox();
+        const auto& aos = pti.GetArrayOfStructs();
+        const PC::ParticleType* pstruct = aos().dataPtr();
+        const auto& bins = pc.CellSortedBins(lev, pti.index(), pti.LocalTileIndex());
+        AMREX_ALWAYS_ASSERT(bins.numItems() == pti.numParticles());
+        AMREX_ALWAYS_ASSERT(bins.numBins() == tbx.numPts());
+
+        auto cell_of = [&] (unsigned int i) {
+            return getParticleCell(pstruct[i], plo, dxi, domain) - tbx.smallEnd();
+        };
+
+        // The permutation is the identity after the gather.
+        for (int k = 0; k < bins.numItems(); ++k) {
+            AMREX_ALWAYS_ASSERT(bins.permutationPtr()[k] == static_cast<unsigned int>(k));
+        }
+
+        DenseBins<PC::ParticleType> ref;
+        ref.build(pti.numParticles(), pstruct, tbx,
+                  [=] (const PC::ParticleType& p) noexcept -> IntVect
+                  {
+                      return getParticleCell(p, plo, dxi, domain) - tbx.smallEnd();
+                  });
+        checkSameBins(bins, ref, tbx, cell_of);
+    }
+}
+
+// SortParticlesByCell, and the update of it after some particles moved to
+// other cells of their tile.
+void testSortParticlesByCell (const TestParams& params)
+{
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+
+    const Box domain(IntVect::TheZeroVector(), params.size - IntVect::TheUnitVector());
+    int is_per[] = {AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    PC pc(geom, dm, ba);
+
+    const long np = long(params.num_ppc) * domain.numPts();
+    PC::ParticleInitData pdata = {};
+    pc.InitRandom(np, 451, pdata, false);
+
+    pc.SortParticlesByCell();
+    checkCellSorted(pc);
+
+    // Move every 8th particle to a random cell of its tile.
+    const auto plo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    std::mt19937 gen(ParallelDescriptor::MyProc());
+    std::uniform_real_distribution<Real> unif(0.0, 1.0);
+    for (PC::ParIterType pti(pc, 0); pti.isValid(); ++pti)
+    {
+        const Box& tbx = pti.tilebox();
+        auto& aos = pti.GetArrayOfStructs();
+        for (int i = 0; i < pti.numParticles(); i += 8)
+        {
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                aos[i].pos(d) = plo[d] + (tbx.smallEnd(d) + tbx.length(d)*unif(gen)) * dx[d];
+            }
+        }
+    }
+
+    pc.SortParticlesByCell();
+    checkCellSorted(pc);
+
+    amrex::Print() << "SortParticlesByCell keeps each tile sorted by cell\n";
+}
+
+// The neighbor list, with its bins updated between builds, against a brute force count.
+void testNeighborList ()
+{
+    using ParticleType = Particle<0>;
+
+    const Box bx(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(7,7,7)));
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+    Geometry geom(bx, &real_box, CoordSys::cartesian, nullptr);
+    const Real cutoff = geom.CellSize(0);
+
+    std::mt19937 gen(451);
+    std::uniform_real_distribution<Real> unif(0.0, 1.0);
+    Gpu::ManagedVector<ParticleType> vec(8*bx.numPts());
+    for (auto& p : vec) {
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) p.pos(d) = unif(gen);
+    }
+
+    auto check_pair = [=] AMREX_GPU_HOST_DEVICE (const ParticleType& p1,
+                                                 const ParticleType& p2) noexcept
+    {
+        Real r2 = 0.0;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            r2 += (p1.pos(d)-p2.pos(d))*(p1.pos(d)-p2.pos(d));
+        }
+        return r2 <= cutoff*cutoff;
+    };
+
+    auto brute_force = [&] ()
+    {
+        long n = 0;
+        for (std::size_t i = 0; i < vec.size(); ++i) {
+            for (std::size_t j = 0; j < vec.size(); ++j) {
+                if (i != j && check_pair(vec[i], vec[j])) ++n;
+            }
+        }
+        return n;
+    };
+
+    NeighborList<ParticleType> nlist;
+    nlist.build(vec, bx, geom, check_pair);
+    AMREX_ALWAYS_ASSERT(nlist.numNeighbors() == brute_force());
+
+    // Move some particles to other cells and build again.
+    for (std::size_t i = 0; i < vec.size(); i += 6) {
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) vec[i].pos(d) = unif(gen);
+    }
+    nlist.build(vec, bx, geom, check_pair);
+    AMREX_ALWAYS_ASSERT(nlist.numNeighbors() == brute_force());
+
+    amrex::Print() << "NeighborList finds all pairs\n";
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        ParmParse pp("bins");
+
+        TestParams params;
+        pp.get("size", params.size);
+        pp.get("max_grid_size", params.max_grid_size);
+        pp.get("num_ppc", params.num_ppc);
+
+        testUpdate();
+        testSortParticlesByCell(params);
+        testNeighborList();
+    }
+    amrex::Finalize();
+}
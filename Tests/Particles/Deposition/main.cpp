@@ -0,0 +1,234 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleMesh.H>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace amrex;
+
+// charge, vx, vy, vz
+using PC = ParticleContainer<1 + AMREX_SPACEDIM>;
+
+struct TestParams
+{
+    IntVect size;
+    int max_grid_size;
+    int num_ppc;
+    int nrepeat;
+    IntVect tile_size;
+};
+
+// The charge goes into component 0 and the current into the others.
+struct ChargeAndCurrent
+{
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    Real operator() (const PC::ParticleType& p, int comp) const noexcept
+    {
+        return (comp == 0) ? p.rdata(0) : p.rdata(0)*p.rdata(comp);
+    }
+};
+
+void depositAtomic (const PC& pc, MultiFab& mf)
+{
+    const auto plo = pc.Geom(0).ProbLoArray();
+    const auto dxi = pc.Geom(0).InvCellSizeArray();
+    const int nc = mf.nComp();
+    amrex::ParticleToMesh(pc, mf, 0,
+        [=] AMREX_GPU_DEVICE (const PC::ParticleType& p, Array4<Real> const& rho)
+        {
+            Real lx = (p.pos(0) - plo[0]) * dxi[0] + 0.5;
+            Real ly = (p.pos(1) - plo[1]) * dxi[1] + 0.5;
+            Real lz = (p.pos(2) - plo[2]) * dxi[2] + 0.5;
+
+            int i = std::floor(lx);
+            int j = std::floor(ly);
+            int k = std::floor(lz);
+
+            Real xint = lx - i;
+            Real yint = ly - j;
+            Real zint = lz - k;
+
+            Real sx[] = {1.-xint, xint};
+            Real sy[] = {1.-yint, yint};
+            Real sz[] = {1.-zint, zint};
+
+            for (int comp = 0; comp < nc; ++comp) {
+                const Real w = ChargeAndCurrent()(p, comp);
+                for (int kk = 0; kk <= 1; ++kk) {
+                    for (int jj = 0; jj <= 1; ++jj) {
+                        for (int ii = 0; ii <= 1; ++ii) {
+                            Gpu::Atomic::Add(&rho(i+ii-1, j+jj-1, k+kk-1, comp),
+                                             sx[ii]*sy[jj]*sz[kk]*w);
+                        }
+                    }
+                }
+            }
+        });
+}
+
+template <class F>
+Real timeIt (int nrepeat, F&& f)
+{
+    f();  // warm up
+    ParallelDescriptor::Barrier();
+    Real t0 = amrex::second();
+    for (int i = 0; i < nrepeat; ++i) f();
+    Real t = (amrex::second() - t0) / nrepeat;
+    ParallelDescriptor::ReduceRealMax(t);
+    return t;
+}
+
+void testDeposition (const TestParams& params)
+{
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+
+    const Box domain(IntVect::TheZeroVector(), params.size - IntVect::TheUnitVector());
+    int is_per[] = {AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    PC pc(geom, dm, ba);
+
+    const long np = long(params.num_ppc) * domain.numPts();
+    PC::ParticleInitData pdata = {1.0, AMREX_D_DECL(1.0, -2.0, 3.0)};
+    pc.InitRandom(np, 451, pdata, false);
+
+    const int ncomp = 1 + AMREX_SPACEDIM;
+    MultiFab rho_atomic(ba, dm, ncomp, 1);
+    MultiFab rho_cic(ba, dm, ncomp, 1);
+    MultiFab rho_tsc(ba, dm, ncomp, 1);
+
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    const Real ncores = Real(ParallelDescriptor::NProcs() * nthreads);
+
+    auto report = [&] (const std::string& name, Real t)
+    {
+        amrex::Print() << "  " << std::left << std::setw(24) << name
+                       << std::setw(14) << t << " s  "
+                       << np / t / ncores << " particles/s/core\n";
+    };
+
+    amrex::Print() << "Depositing " << np << " particles on " << ncores << " cores\n";
+
+    for (int sorted = 0; sorted <= 1; ++sorted)
+    {
+        if (sorted) pc.SortParticlesByCell();
+        amrex::Print() << (sorted ? "Particles sorted by cell:\n" : "Particles unsorted:\n");
+
+        report("atomic CIC", timeIt(params.nrepeat, [&] () { depositAtomic(pc, rho_atomic); }));
+        report("tile-local CIC", timeIt(params.nrepeat, [&] () {
+            amrex::ParticleToMesh(pc, rho_cic, 0, DepositionShape::CIC, ChargeAndCurrent());
+        }));
+        report("tile-local TSC", timeIt(params.nrepeat, [&] () {
+            amrex::ParticleToMesh(pc, rho_tsc, 0, DepositionShape::TSC, ChargeAndCurrent());
+        }));
+
+        // The two CIC depositions must agree, and the shapes conserve charge.
+        MultiFab::Subtract(rho_atomic, rho_cic, 0, 0, ncomp, 0);
+        Real maxdiff = 0.0;
+        for (int comp = 0; comp < ncomp; ++comp) {
+            maxdiff = std::max(maxdiff, rho_atomic.norm0(comp, 0));
+        }
+        const Real qtot = Real(np);
+        const Real qcic = rho_cic.sum(0);
+        const Real qtsc = rho_tsc.sum(0);
+        amrex::Print() << "  max |atomic - tile-local| = " << maxdiff
+                       << ", charge error CIC " << std::abs(qcic - qtot)/qtot
+                       << ", TSC " << std::abs(qtsc - qtot)/qtot << "\n";
+        AMREX_ALWAYS_ASSERT(maxdiff < 1.e-10 * params.num_ppc);
+        AMREX_ALWAYS_ASSERT(std::abs(qcic - qtot) < 1.e-10 * qtot);
+        AMREX_ALWAYS_ASSERT(std::abs(qtsc - qtot) < 1.e-10 * qtot);
+    }
+}
+
+// With particle tiling, the tile-local deposition of the tiles of a grid
+// overlaps in the cells around each tile.  Compare it with the deposition
+// of the same particles without tiling.
+void testTiledDeposition (const TestParams& params)
+{
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+
+    const Box domain(IntVect::TheZeroVector(), params.size - IntVect::TheUnitVector());
+    int is_per[] = {AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    const long np = long(params.num_ppc) * domain.numPts();
+    PC::ParticleInitData pdata = {1.0, AMREX_D_DECL(1.0, -2.0, 3.0)};
+
+    const int ncomp = 1 + AMREX_SPACEDIM;
+    const bool do_tiling = PC::do_tiling;
+    const IntVect tile_size = PC::tile_size;
+
+    Vector<MultiFab> rho(2);
+    for (int tiled = 0; tiled <= 1; ++tiled)
+    {
+        PC::do_tiling = tiled;
+        PC::tile_size = params.tile_size;
+
+        PC pc(geom, dm, ba);
+        pc.InitRandom(np, 451, pdata, false);
+
+        rho[tiled].define(ba, dm, 2*ncomp, 1);
+        MultiFab rho_cic(rho[tiled], amrex::make_alias, 0, ncomp);
+        MultiFab rho_tsc(rho[tiled], amrex::make_alias, ncomp, ncomp);
+        amrex::ParticleToMesh(pc, rho_cic, 0, DepositionShape::CIC, ChargeAndCurrent());
+        amrex::ParticleToMesh(pc, rho_tsc, 0, DepositionShape::TSC, ChargeAndCurrent());
+    }
+
+    PC::do_tiling = do_tiling;
+    PC::tile_size = tile_size;
+
+    MultiFab::Subtract(rho[1], rho[0], 0, 0, 2*ncomp, 0);
+    Real maxdiff = 0.0;
+    for (int comp = 0; comp < 2*ncomp; ++comp) {
+        maxdiff = std::max(maxdiff, rho[1].norm0(comp, 0));
+    }
+    amrex::Print() << "Tiles of size " << params.tile_size
+                   << ": max |tiled - untiled| = " << maxdiff << "\n";
+    AMREX_ALWAYS_ASSERT(maxdiff < 1.e-10 * params.num_ppc);
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        ParmParse pp("deposit");
+
+        TestParams params;
+        pp.get("size", params.size);
+        pp.get("max_grid_size", params.max_grid_size);
+        pp.get("num_ppc", params.num_ppc);
+        params.nrepeat = 5;
+        pp.query("nrepeat", params.nrepeat);
+        params.tile_size = IntVect(AMREX_D_DECL(8,8,8));
+        pp.query("tile_size", params.tile_size);
+
+        testDeposition(params);
+        testTiledDeposition(params);
+    }
+    amrex::Finalize();
+}
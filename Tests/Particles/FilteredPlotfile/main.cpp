@@ -0,0 +1,183 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleUtil.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+namespace {
+
+static constexpr int NSR = 2;
+static constexpr int NSI = 1;
+static constexpr int NAR = 1;
+static constexpr int NAI = 1;
+
+using PC = ParticleContainer<NSR, NSI, NAR, NAI>;
+using ParticleType = PC::ParticleType;
+
+// Real component i of particle id; not exactly representable as a float.
+ParticleReal realValue (int id, int i) { return id + 0.1*(i+1); }
+
+// One particle per cell, with the real data set to realValue and the int
+// data to the id.
+void initParticles (PC& pc)
+{
+    const Geometry& geom = pc.Geom(0);
+    const auto plo = geom.ProbLoArray();
+    const auto dx  = geom.CellSizeArray();
+
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi.index(), mfi.LocalTileIndex());
+        for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+        {
+            ParticleType p;
+            p.id()  = ParticleType::NextID();
+            p.cpu() = ParallelDescriptor::MyProc();
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                p.pos(d) = plo[d] + (iv[d] + 0.5)*dx[d];
+            }
+            for (int i = 0; i < NSR; ++i) p.rdata(i) = realValue(p.id(), i);
+            for (int i = 0; i < NSI; ++i) p.idata(i) = p.id();
+            ptile.push_back(p);
+            for (int i = 0; i < NAR; ++i) ptile.push_back_real(i, realValue(p.id(), NSR+i));
+            for (int i = 0; i < NAI; ++i) ptile.push_back_int(i, p.id());
+        }
+    }
+}
+
+// The sorted ids of the particles for which f is true, on the I/O rank.
+template <class F>
+Vector<Long> gatherIds (const PC& pc, F const& f)
+{
+    Vector<Long> ids;
+    for (PC::ParConstIterType pti(pc, 0); pti.isValid(); ++pti) {
+        for (auto const& p : pti.GetArrayOfStructs()) {
+            if (f(p)) ids.push_back(p.id());
+        }
+    }
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+    const int nlocal = ids.size();
+    Vector<int> counts(nprocs), offsets(nprocs, 0);
+    ParallelDescriptor::Gather(&nlocal, 1, counts.data(), 1, ioproc);
+    for (int i = 1; i < nprocs; ++i) offsets[i] = offsets[i-1] + counts[i-1];
+
+    Vector<Long> all_ids(ParallelDescriptor::IOProcessor() ? offsets[nprocs-1] + counts[nprocs-1] : 0);
+    ParallelDescriptor::Gatherv(ids.data(), nlocal, all_ids.data(), counts, offsets, ioproc);
+    std::sort(all_ids.begin(), all_ids.end());
+    return all_ids;
+}
+
+// Write pc with the filter, read it back, and check that exactly the
+// selected particles come back with the data rounded as expected.
+template <class F>
+void testWrite (const std::string& name, const PC& pc, F const& f, bool single_precision)
+{
+    const Vector<int> write_real(NSR+NAR, 1);
+    const Vector<int> write_int(NSI+NAI, 1);
+    const Vector<std::string> real_names{"r0", "r1", "r2"};
+    const Vector<std::string> int_names{"i0", "i1"};
+    pc.WritePlotFile(name, "particles", write_real, write_int, real_names, int_names,
+                     f, single_precision);
+
+    PC pc2(pc.Geom(0), pc.ParticleDistributionMap(0), pc.ParticleBoxArray(0));
+    pc2.Restart(name, "particles");
+
+    const Vector<Long> ids = gatherIds(pc, f);
+    if (pc2.TotalNumberOfParticles() != static_cast<Long>(ids.size()) &&
+        ParallelDescriptor::IOProcessor()) {
+        amrex::Abort(name + ": wrong number of particles");
+    }
+    if (gatherIds(pc2, [] (ParticleType const&) { return true; }) != ids) {
+        amrex::Abort(name + ": the selected particles were not written");
+    }
+
+    // The data as written: float if single_precision, exact otherwise.
+    auto expected = [=] (ParticleReal x) -> ParticleReal {
+        return single_precision ? static_cast<ParticleReal>(static_cast<float>(x)) : x;
+    };
+
+    bool data_ok = true;
+    for (PC::ParConstIterType pti(pc2, 0); pti.isValid(); ++pti)
+    {
+        auto const& aos = pti.GetArrayOfStructs();
+        auto const& soa = pti.GetStructOfArrays();
+        for (int i = 0; i < pti.numParticles(); ++i) {
+            const auto& p = aos[i];
+            for (int n = 0; n < NSR; ++n) {
+                data_ok = data_ok && p.rdata(n) == expected(realValue(p.id(), n));
+            }
+            for (int n = 0; n < NAR; ++n) {
+                data_ok = data_ok && soa.GetRealData(n)[i] == expected(realValue(p.id(), NSR+n));
+            }
+            for (int n = 0; n < NSI; ++n) data_ok = data_ok && p.idata(n) == p.id();
+            for (int n = 0; n < NAI; ++n) data_ok = data_ok && soa.GetIntData(n)[i] == p.id();
+        }
+    }
+    ParallelDescriptor::ReduceBoolAnd(data_ok);
+    if (!data_ok) {
+        amrex::Abort(name + ": the particle data were not written as expected");
+    }
+
+    amrex::Print() << name << ": " << ids.size() << " particles, pass\n";
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        ParmParse pp("plotfile");
+        IntVect size(AMREX_D_DECL(64,32,32));
+        pp.query("size", size);
+        int max_grid_size = 32;
+        pp.query("max_grid_size", max_grid_size);
+        int stride = 4;
+        pp.query("stride", stride);
+
+        RealBox real_box;
+        for (int n = 0; n < AMREX_SPACEDIM; n++) {
+            real_box.setLo(n, 0.0);
+            real_box.setHi(n, 1.0);
+        }
+        const Box domain(IntVect(AMREX_D_DECL(0,0,0)), size - 1);
+        const Geometry geom(domain, &real_box);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        const DistributionMapping dm(ba);
+
+        PC pc(geom, dm, ba);
+        initParticles(pc);
+
+        // Every particle, so each grid is written in several packs.
+        auto all = [] (ParticleType const&) { return true; };
+        testWrite("plt_all_double", pc, all, false);
+        testWrite("plt_all_single", pc, all, true);
+
+        // About one in stride particles.
+        const ParticleIDSubsample subsample(stride);
+        testWrite("plt_subsample_double", pc, subsample, false);
+        testWrite("plt_subsample_single", pc, subsample, true);
+
+        // About the right fraction is kept, and another seed selects another
+        // subset.
+        const auto ids = gatherIds(pc, subsample);
+        const Long ntotal = pc.TotalNumberOfParticles();
+        if (ParallelDescriptor::IOProcessor() &&
+            (ids.empty() || std::abs(double(ids.size())*stride - ntotal) > 0.1*ntotal)) {
+            amrex::Abort("ParticleIDSubsample: did not keep about one in every stride particles");
+        }
+        if (gatherIds(pc, ParticleIDSubsample(stride, 12345)) == ids &&
+            ParallelDescriptor::IOProcessor()) {
+            amrex::Abort("ParticleIDSubsample: the seed does not change the selection");
+        }
+    }
+    amrex::Finalize();
+}
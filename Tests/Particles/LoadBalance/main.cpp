@@ -6,6 +6,7 @@
 #include <AMReX_Particles.H>
 #include <AMReX_PlotFileUtil.H>
 #include <AMReX_LoadBalanceKD.H>
+#include <AMReX_ParticleLoadBalance.H>
 
 using namespace amrex;
 
@@ -15,63 +16,106 @@ int main(int argc, char* argv[])
 {
     amrex::Initialize(argc, argv);
 
-    int num_cells, max_grid_size, num_procs;
+    {
+        int num_cells, max_grid_size, num_procs;
    
-    ParmParse pp;    
-    pp.get("num_cells", num_cells);
-    pp.get("num_procs", num_procs);
-    pp.get("max_grid_size", max_grid_size);
-
-    RealBox real_box;
-    for (int n = 0; n < BL_SPACEDIM; n++) {
-        real_box.setLo(n, 0.0);
-        real_box.setHi(n, 1.0);
-    }
+        ParmParse pp;    
+        pp.get("num_cells", num_cells);
+        pp.get("num_procs", num_procs);
+        pp.get("max_grid_size", max_grid_size);
+
+        RealBox real_box;
+        for (int n = 0; n < BL_SPACEDIM; n++) {
+            real_box.setLo(n, 0.0);
+            real_box.setHi(n, 1.0);
+        }
 
-    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
-    IntVect domain_hi(AMREX_D_DECL(num_cells - 1, num_cells - 1, num_cells - 1));
-    const Box domain(domain_lo, domain_hi);
+        IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+        IntVect domain_hi(AMREX_D_DECL(num_cells - 1, num_cells - 1, num_cells - 1));
+        const Box domain(domain_lo, domain_hi);
     
-    int is_per[BL_SPACEDIM];
-    for (int i = 0; i < BL_SPACEDIM; i++) 
-        is_per[i] = 0; 
-    Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+        int is_per[BL_SPACEDIM];
+        for (int i = 0; i < BL_SPACEDIM; i++) 
+            is_per[i] = 0; 
+        Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
     
-    BoxArray ba(domain);
-    ba.maxSize(max_grid_size);
-    DistributionMapping dmap(ba);
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dmap(ba);
 
-    MyParticleContainer myPC(geom, dmap, ba);    
-    MyParticleContainer::ParticleInitData pdata = {};
-    myPC.InitFromBinaryFile("binary_particle_file.dat", 0);
+        MyParticleContainer myPC(geom, dmap, ba);    
+        MyParticleContainer::ParticleInitData pdata = {};
+        myPC.InitFromBinaryFile("binary_particle_file.dat", 0);
 
-    BoxArray new_ba;
-    Vector<Real> costs;
-    loadBalanceKD::balance<MyParticleContainer>(myPC, new_ba, num_procs, 0.0, costs);
+        BoxArray new_ba;
+        Vector<Real> costs;
+        loadBalanceKD::balance<MyParticleContainer>(myPC, new_ba, num_procs, 0.0, costs);
 
-    std::cout << new_ba << std::endl;    
-    for (int i = 0; i < new_ba.size(); ++i) {
-        std::cout << costs[i] << std::endl;
-    }
+        std::cout << new_ba << std::endl;    
+        for (int i = 0; i < new_ba.size(); ++i) {
+            std::cout << costs[i] << std::endl;
+        }
 
-    Vector<int> new_pmap;
-    for (int i = 0; i < new_ba.size(); ++i) {
-        new_pmap.push_back(0);
-    }
+        Vector<int> new_pmap;
+        for (int i = 0; i < new_ba.size(); ++i) {
+            new_pmap.push_back(0);
+        }
 
-    DistributionMapping new_dm(new_pmap);
+        DistributionMapping new_dm(new_pmap);
 
-    myPC.SetParticleBoxArray(0, new_ba);
-    myPC.SetParticleDistributionMap(0, new_dm);
-    
-    myPC.Redistribute();
-    MultiFab new_local_cost;
-    MultiFab new_global_cost;    
-    loadBalanceKD::computeCost<MyParticleContainer>(myPC, new_local_cost, new_global_cost, domain, 0.0);
-
-    WriteSingleLevelPlotfile("plt00000", new_local_cost, {"cost"},
-                             geom, 0.0, 0);
-    myPC.Checkpoint("plt00000", "particle0", true);
+        myPC.SetParticleBoxArray(0, new_ba);
+        myPC.SetParticleDistributionMap(0, new_dm);
     
+        myPC.Redistribute();
+        MultiFab new_local_cost;
+        MultiFab new_global_cost;    
+        loadBalanceKD::computeCost<MyParticleContainer>(myPC, new_local_cost, new_global_cost, domain, 0.0);
+
+        WriteSingleLevelPlotfile("plt00000", new_local_cost, {"cost"},
+                                 geom, 0.0, 0);
+        myPC.Checkpoint("plt00000", "particle0", true);
+
+        // All the boxes are on process 0 now, so with more than one process the
+        // level is imbalanced on purpose.
+        LoadBalanceCostModel model;
+        Vector<Real> box_costs = loadBalance::computeCost(myPC, 0, model);
+        const Real imbalance_before = myPC.ParticleDistributionMap(0).computeImbalance(box_costs);
+        amrex::Print() << "imbalance before rebalance: " << imbalance_before << "\n";
+
+        const DistributionMapping old_dm = myPC.ParticleDistributionMap(0);
+        MultiFab old_local_cost(new_local_cost.boxArray(), old_dm, new_local_cost.nComp(), 0);
+        MultiFab::Copy(old_local_cost, new_local_cost, 0, 0, new_local_cost.nComp(), 0);
+
+        const long np = myPC.TotalNumberOfParticles();
+        const bool moved = loadBalance::rebalance(myPC, 0, 1.1, model, {&new_local_cost});
+        AMREX_ALWAYS_ASSERT(myPC.TotalNumberOfParticles() == np);
+        AMREX_ALWAYS_ASSERT(myPC.OK());
+
+        box_costs = loadBalance::computeCost(myPC, 0, model);
+        const Real imbalance_after = myPC.ParticleDistributionMap(0).computeImbalance(box_costs);
+        amrex::Print() << "imbalance after rebalance: " << imbalance_after << "\n";
+
+        AMREX_ALWAYS_ASSERT(imbalance_after <= imbalance_before);
+        if (ParallelDescriptor::NProcs() > 1) {
+            AMREX_ALWAYS_ASSERT(moved);
+            AMREX_ALWAYS_ASSERT(imbalance_after < imbalance_before);
+            AMREX_ALWAYS_ASSERT(myPC.ParticleDistributionMap(0) != old_dm);
+        } else {
+            AMREX_ALWAYS_ASSERT(!moved);
+        }
+
+        // The mesh data moved with the particles, unchanged.
+        AMREX_ALWAYS_ASSERT(new_local_cost.DistributionMap() == myPC.ParticleDistributionMap(0));
+        MultiFab moved_local_cost(new_local_cost.boxArray(), old_dm, new_local_cost.nComp(), 0);
+        moved_local_cost.ParallelCopy(new_local_cost, 0, 0, new_local_cost.nComp());
+        MultiFab::Subtract(moved_local_cost, old_local_cost, 0, 0, new_local_cost.nComp(), 0);
+        AMREX_ALWAYS_ASSERT(moved_local_cost.norm0(0) == 0.0);
+
+        // A level that is balanced enough is left alone.
+        const DistributionMapping balanced_dm = myPC.ParticleDistributionMap(0);
+        AMREX_ALWAYS_ASSERT(!loadBalance::rebalance(myPC, 0, std::max(imbalance_after, Real(1.1)), model));
+        AMREX_ALWAYS_ASSERT(myPC.ParticleDistributionMap(0) == balanced_dm);
+    }
+
     amrex::Finalize();
 }
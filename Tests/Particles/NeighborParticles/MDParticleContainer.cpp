@@ -127,6 +127,7 @@ std::pair<Real, Real> MDParticleContainer::minAndMaxDistance()
         auto& aos   = ptile.GetArrayOfStructs();
         const size_t np = aos.numParticles();
 
+#ifdef AMREX_USE_CUDA
         auto nbor_data = m_neighbor_list[index].data();
         ParticleType* pstruct = aos().dataPtr();
 
@@ -159,6 +160,34 @@ std::pair<Real, Real> MDParticleContainer::minAndMaxDistance()
 
 	min_d = std::min(min_d, min_d_gpu.dataValue());
 	max_d = std::max(max_d, max_d_gpu.dataValue());
+#else
+        const auto& nl    = GetNeighborList(lev, gid, tid);
+        const auto& nbors = GetNeighbors(lev, gid, tid);
+
+        int ind = 0;
+        for (size_t i = 0; i < np; ++i)
+        {
+            const ParticleType& p1 = aos[i];
+            const int num_partners = nl[ind++];
+            for (int k = ind; k < ind + num_partners; ++k)
+            {
+                const size_t j = nl[k] - 1;
+                const ParticleType& p2 = (j < np) ? aos[j] : nbors[j - np];
+
+                Real dx = p1.pos(0) - p2.pos(0);
+                Real dy = p1.pos(1) - p2.pos(1);
+                Real dz = p1.pos(2) - p2.pos(2);
+
+                Real r2 = dx*dx + dy*dy + dz*dz;
+                r2 = amrex::max(r2, Params::min_r*Params::min_r);
+                Real r = sqrt(r2);
+
+                min_d = std::min(min_d, r);
+                max_d = std::max(max_d, r);
+            }
+            ind += num_partners;
+        }
+#endif
     }
     ParallelDescriptor::ReduceRealMin(min_d, ParallelDescriptor::IOProcessorNumber());
     ParallelDescriptor::ReduceRealMax(max_d, ParallelDescriptor::IOProcessorNumber());
@@ -318,7 +347,14 @@ void MDParticleContainer::checkNeighborList()
         auto& aos   = ptile.GetArrayOfStructs();
 
         const size_t np       = aos.numParticles();
+#ifdef AMREX_USE_CUDA
         const size_t np_total = aos.numTotalParticles();
+#else
+        // The CPU path keeps the neighbors apart from the particles.
+        const auto& nl    = GetNeighborList(lev, gid, tid);
+        const auto& nbors = GetNeighbors(lev, gid, tid);
+        const size_t np_total = np + nbors.size();
+#endif
 
         amrex::Gpu::ManagedVector<int> d_neighbor_count(np,0);
         int* p_neighbor_count = d_neighbor_count.data();
@@ -326,8 +362,13 @@ void MDParticleContainer::checkNeighborList()
         amrex::Gpu::ManagedVector<int> d_full_count(np,0);
         int* p_full_count = d_full_count.data();
 
+#ifdef AMREX_USE_CUDA
         auto nbor_data = m_neighbor_list[index].data();
         ParticleType* pstruct = aos().dataPtr();
+#else
+        auto particle = [&] (size_t j) -> const ParticleType& { return (j < np) ? aos[j] : nbors[j - np]; };
+        int ind = 0;
+#endif
 
         // ON DEVIDE: 
         // AMREX_FOR_1D ( np, i,
@@ -335,7 +376,11 @@ void MDParticleContainer::checkNeighborList()
         // for (int i = 0; i < np; i++)
         for (int i = 0; i < np; i++)
         {
+#ifdef AMREX_USE_CUDA
             ParticleType& p1 = pstruct[i];
+#else
+            const ParticleType& p1 = particle(i);
+#endif
 
             amrex::Vector<int> nbor_nbors;
             amrex::Vector<int> full_nbors;
@@ -346,7 +391,11 @@ void MDParticleContainer::checkNeighborList()
                 // Don't be your own neighbor.
                 if ( i == j ) continue;
 
+#ifdef AMREX_USE_CUDA
                 ParticleType& p2 = pstruct[j];
+#else
+                const ParticleType& p2 = particle(j);
+#endif
                 Real dx = p1.pos(0) - p2.pos(0);
                 Real dy = p1.pos(1) - p2.pos(1);
                 Real dz = p1.pos(2) - p2.pos(2);
@@ -362,11 +411,21 @@ void MDParticleContainer::checkNeighborList()
 		}
             }
 
+#ifdef AMREX_USE_CUDA
             for (const auto& p2 : nbor_data.getNeighbors(i))
             {               
                 Gpu::Atomic::Add(&(p_neighbor_count[i]),1);
                 nbor_nbors.push_back(p2.id());
             }
+#else
+            const int num_partners = nl[ind++];
+            for (int k = ind; k < ind + num_partners; ++k)
+            {
+                Gpu::Atomic::Add(&(p_neighbor_count[i]),1);
+                nbor_nbors.push_back(particle(nl[k] - 1).id());
+            }
+            ind += num_partners;
+#endif
 
             std::sort(full_nbors.begin(), full_nbors.end());
             std::sort(nbor_nbors.begin(), nbor_nbors.end());
@@ -429,3 +488,145 @@ void MDParticleContainer::reset_test_id()
         });
     }
 }
+
+std::pair<long, long> MDParticleContainer::countNeighborPairs()
+{
+    BL_PROFILE("MDParticleContainer::countNeighborPairs");
+
+    const int lev = 0;
+    auto& plev  = GetParticles(lev);
+
+    long num_pairs = 0;
+    long num_self_pairs = 0;
+
+    for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        int gid = mfi.index();
+        int tid = mfi.LocalTileIndex();
+        auto index = std::make_pair(gid, tid);
+
+        auto& aos = plev[index].GetArrayOfStructs();
+        const size_t np = aos.numParticles();
+
+#ifdef AMREX_USE_CUDA
+        auto nbor_data = m_neighbor_list[index].data();
+        for (size_t i = 0; i < np; ++i)
+        {
+            const ParticleType& p1 = aos[i];
+            for (const auto& p2 : nbor_data.getNeighbors(i))
+            {
+                ++num_pairs;
+                if (p1.id() == p2.id() && p1.cpu() == p2.cpu()) ++num_self_pairs;
+            }
+        }
+#else
+        const auto& nl    = GetNeighborList(lev, gid, tid);
+        const auto& nbors = GetNeighbors(lev, gid, tid);
+
+        int ind = 0;
+        for (size_t i = 0; i < np; ++i)
+        {
+            const ParticleType& p1 = aos[i];
+            const int num_partners = nl[ind++];
+            for (int k = ind; k < ind + num_partners; ++k)
+            {
+                const size_t j = nl[k] - 1;
+                const ParticleType& p2 = (j < np) ? aos[j] : nbors[j - np];
+                ++num_pairs;
+                if (p1.id() == p2.id() && p1.cpu() == p2.cpu()) ++num_self_pairs;
+            }
+            ind += num_partners;
+        }
+#endif
+    }
+
+    ParallelDescriptor::ReduceLongSum(num_pairs);
+    ParallelDescriptor::ReduceLongSum(num_self_pairs);
+
+    return std::make_pair(num_pairs, num_self_pairs);
+}
+
+void MDParticleContainer::computePairSums()
+{
+    BL_PROFILE("MDParticleContainer::computePairSums");
+
+    const int lev = 0;
+    auto& plev  = GetParticles(lev);
+    const bool half = halfNeighborList();
+
+    for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        int gid = mfi.index();
+        int tid = mfi.LocalTileIndex();
+
+        auto& aos   = plev[std::make_pair(gid, tid)].GetArrayOfStructs();
+        auto& nbors = GetNeighbors(lev, gid, tid);
+        const auto& nl = GetNeighborList(lev, gid, tid);
+        const size_t np = aos.numParticles();
+
+        // The neighbors start from zero too, since with a half list they
+        // collect the other half of the pairs.
+        for (size_t i = 0; i < np + nbors.size(); ++i)
+        {
+            ParticleType& p = (i < np) ? aos[i] : nbors[i - np];
+            p.rdata(PIdx::ax) = 0.0;
+            p.rdata(PIdx::ay) = 0.0;
+            p.rdata(PIdx::az) = 0.0;
+        }
+
+        int ind = 0;
+        for (size_t i = 0; i < np; ++i)
+        {
+            ParticleType& p1 = aos[i];
+            const int num_partners = nl[ind++];
+            for (int k = ind; k < ind + num_partners; ++k)
+            {
+                const size_t j = nl[k] - 1;
+                ParticleType& p2 = (j < np) ? aos[j] : nbors[j - np];
+
+                Real dx = p1.pos(0) - p2.pos(0);
+                Real dy = p1.pos(1) - p2.pos(1);
+                Real dz = p1.pos(2) - p2.pos(2);
+                Real r2 = dx*dx + dy*dy + dz*dz;
+
+                // the number of partners, and one symmetric and one
+                // antisymmetric term that differ from pair to pair.
+                const Real count = 1.0;
+                const Real asym  = p2.rdata(PIdx::vx) - p1.rdata(PIdx::vx);
+                const Real sym   = r2*(p1.rdata(PIdx::vy) + p2.rdata(PIdx::vy));
+
+                p1.rdata(PIdx::ax) += count;
+                p1.rdata(PIdx::ay) += asym;
+                p1.rdata(PIdx::az) += sym;
+
+                if (half)
+                {
+                    p2.rdata(PIdx::ax) += count;
+                    p2.rdata(PIdx::ay) -= asym;
+                    p2.rdata(PIdx::az) += sym;
+                }
+            }
+            ind += num_partners;
+        }
+    }
+
+    if (half) sumNeighbors(PIdx::ax, 3, 0, 0);
+}
+
+std::map<std::pair<int, int>, std::array<Real, 3> > MDParticleContainer::pairSums()
+{
+    BL_PROFILE("MDParticleContainer::pairSums");
+
+    const int lev = 0;
+    std::map<std::pair<int, int>, std::array<Real, 3> > sums;
+
+    for (MyParIter pti(*this, lev); pti.isValid(); ++pti)
+    {
+        for (const auto& p : pti.GetArrayOfStructs())
+        {
+            sums[std::make_pair(p.id(), p.cpu())] = {{p.rdata(PIdx::ax), p.rdata(PIdx::ay), p.rdata(PIdx::az)}};
+        }
+    }
+
+    return sums;
+}
@@ -1,13 +1,7 @@
-#include <AMReX.H>
-#include <AMReX_ParmParse.H>
-#include <AMReX_MultiFab.H>
-
-#include "CheckPair.H"
-
-#include "MDParticleContainer.H"
-
-#include <string>
+#include <ostream>
+#include <utility>
 
+// Before the AMReX headers, so that the operator<< of amrex::Print finds it.
 namespace amrex
 {
     template <typename T, typename S> 
@@ -20,6 +14,16 @@ namespace amrex
     } 
 }
 
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+
+#include "CheckPair.H"
+
+#include "MDParticleContainer.H"
+
+#include <string>
+
 using namespace amrex;
 
 struct TestParams
@@ -34,6 +38,10 @@ void testNeighborParticles();
 
 void testNeighborList();
 
+void testVerletList();
+
+void testHalfNeighborList();
+
 int main (int argc, char* argv[])
 {
     amrex::Initialize(argc,argv);
@@ -44,6 +52,12 @@ int main (int argc, char* argv[])
     amrex::PrintToFile("neighbor_test") << "Running neighbor list test \n";
     testNeighborList();
 
+    amrex::PrintToFile("neighbor_test") << "Running Verlet list test \n";
+    testVerletList();
+
+    amrex::PrintToFile("neighbor_test") << "Running half neighbor list test \n";
+    testHalfNeighborList();
+
     amrex::Finalize();
 }
 
@@ -196,3 +210,149 @@ void testNeighborList ()
 
     pc.checkNeighborList();
 }
+
+void testVerletList ()
+{
+    BL_PROFILE("testVerletList");
+    TestParams params;
+    get_test_params(params, "nbor_list");
+
+    RealBox real_box;
+    for (int n = 0; n < BL_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+    IntVect domain_hi(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1));
+    const Box domain(domain_lo, domain_hi);
+
+    int coord = 0;
+    int is_per[BL_SPACEDIM];
+    for (int i = 0; i < BL_SPACEDIM; i++)
+        is_per[i] = params.is_periodic;
+    Geometry geom(domain, &real_box, coord, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    const int ncells = 1;
+    MDParticleContainer pc(geom, dm, ba, ncells);
+
+    int npc = params.num_ppc;
+    IntVect nppc = IntVect(AMREX_D_DECL(npc, npc, npc));
+
+    pc.InitParticles(nppc, 1.0, 0.0);
+
+    // CheckPair accepts pairs up to one cell apart, so this is the skin
+    // on top of a cutoff of 0.6.
+    const Real skin = 0.4;
+    pc.setVerletSkin(skin);
+    pc.updateNeighborList(CheckPair());
+
+    // Each move is 0.1*sqrt(3), so the list is kept for one step and
+    // rebuilt on the next.
+    for (int step = 1; step <= 4; ++step)
+    {
+        pc.moveParticles(0.1);
+        const bool rebuilt = pc.updateNeighborList(CheckPair());
+        amrex::PrintToFile("neighbor_test") << "Step " << step << (rebuilt ? ": rebuilt" : ": reused")
+                                            << ", min distance is " << pc.minAndMaxDistance()
+                                            << ", should be (1, 1) \n";
+        if (rebuilt != (step % 2 == 0)) {
+            amrex::Abort("testVerletList: the Verlet list was not rebuilt when it should have been");
+        }
+    }
+
+    pc.printNeighborListStats();
+}
+
+void testHalfNeighborList ()
+{
+    BL_PROFILE("testHalfNeighborList");
+    TestParams params;
+    get_test_params(params, "half_list");
+
+    RealBox real_box;
+    for (int n = 0; n < BL_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+    IntVect domain_hi(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1));
+    const Box domain(domain_lo, domain_hi);
+
+    int coord = 0;
+    int is_per[BL_SPACEDIM];
+    for (int i = 0; i < BL_SPACEDIM; i++)
+        is_per[i] = params.is_periodic;
+    Geometry geom(domain, &real_box, coord, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    const int ncells = 1;
+    MDParticleContainer pc(geom, dm, ba, ncells);
+
+    int npc = params.num_ppc;
+    IntVect nppc = IntVect(AMREX_D_DECL(npc, npc, npc));
+
+    pc.setEnableInverse(true);
+    pc.InitParticles(nppc, 1.0, 0.0);
+    pc.fillNeighbors();
+
+    pc.buildNeighborList(CheckPair());
+    const auto full_pairs = pc.countNeighborPairs();
+#ifndef AMREX_USE_CUDA
+    pc.computePairSums();
+    const auto full_sums = pc.pairSums();
+#endif
+
+    pc.setHalfNeighborList(true);
+    pc.buildNeighborList(CheckPair());
+    const auto half_pairs = pc.countNeighborPairs();
+
+    amrex::PrintToFile("neighbor_test") << "Full list has " << full_pairs.first << " pairs, "
+                                        << full_pairs.second << " with a periodic image of the particle itself \n";
+    amrex::PrintToFile("neighbor_test") << "Half list has " << half_pairs.first << " pairs, "
+                                        << half_pairs.second << " with a periodic image of the particle itself \n";
+
+    if (full_pairs.first != 2*half_pairs.first || full_pairs.second != 2*half_pairs.second) {
+        amrex::Abort("testHalfNeighborList: the half list does not have half the pairs of the full list");
+    }
+
+    // With a domain one cell wide, every particle is within the cutoff of
+    // its own images, and the half list has to keep one of each two.
+    if (params.is_periodic && params.size.min() == 1 && half_pairs.second == 0) {
+        amrex::Abort("testHalfNeighborList: the pairs of the particles with their own images are missing");
+    }
+
+    // sumNeighbors is only implemented on the CPU.
+#ifndef AMREX_USE_CUDA
+    pc.computePairSums();
+    const auto half_sums = pc.pairSums();
+
+    AMREX_ALWAYS_ASSERT(full_sums.size() == half_sums.size());
+
+    Real max_diff = 0.0;
+    for (const auto& kv : full_sums)
+    {
+        const auto& half_sum = half_sums.at(kv.first);
+        for (int n = 0; n < 3; ++n) {
+            max_diff = std::max(max_diff, std::abs(kv.second[n] - half_sum[n]));
+        }
+    }
+    ParallelDescriptor::ReduceRealMax(max_diff);
+
+    amrex::PrintToFile("neighbor_test") << "Max difference of the pair sums is " << max_diff << " \n";
+
+    if (max_diff > 1.e-12) {
+        amrex::Abort("testHalfNeighborList: the pair sums with the half list do not match the full list");
+    }
+#endif
+}
@@ -2,6 +2,7 @@
 #include <AMReX_ParmParse.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_Particles.H>
+#include <AMReX_ParticleSoA.H>
 
 using namespace amrex;
 
@@ -478,6 +479,46 @@ void testTwoWayFilterAndTransform (const PC& pc)
     AMREX_ALWAYS_ASSERT(mx3 == 3*mx1);
 }
 
+template <typename PC>
+void testTranspose (const PC& pc)
+{
+    using PType = typename PC::SuperParticleType;
+
+    PC pc2(pc.Geom(0), pc.ParticleDistributionMap(0), pc.ParticleBoxArray(0));
+    pc2.copyParticles(pc);
+
+    auto np_old = pc2.TotalNumberOfParticles();
+    auto np_local = pc2.TotalNumberOfParticles(true, true);
+    auto mx1 = amrex::ReduceMax(pc2, [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> int { return p.idata(NSI+1); });
+    auto sx1 = amrex::ReduceSum(pc2, [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real { return p.pos(0); });
+
+    SoAParticleContainer<NSR, NSI, NAR, NAI> soa_pc(pc2);
+
+    AMREX_ALWAYS_ASSERT(soa_pc.NumberOfParticlesAtLevel(0) == np_old);
+
+    for (SoAParIter<NSR, NSI, NAR, NAI> pti(soa_pc, 0); pti.isValid(); ++pti)
+    {
+        const auto ptd = pti.GetParticleTile().getParticleTileData();
+        const int np = pti.numParticles();
+        ParticleReal* AMREX_RESTRICT x = ptd.m_rdata[0];
+        int* AMREX_RESTRICT ival = ptd.m_idata[2+NSI+1];
+        AMREX_FOR_1D ( np, i,
+        {
+            x[i] += 0.5;
+            ival[i] *= 2;
+        });
+    }
+
+    soa_pc.copyParticlesTo(pc2);
+
+    auto mx2 = amrex::ReduceMax(pc2, [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> int { return p.idata(NSI+1); });
+    auto sx2 = amrex::ReduceSum(pc2, [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real { return p.pos(0); });
+
+    AMREX_ALWAYS_ASSERT(pc2.TotalNumberOfParticles() == np_old);
+    AMREX_ALWAYS_ASSERT(mx2 == 2*mx1);
+    AMREX_ALWAYS_ASSERT(std::abs(sx2 - sx1 - 0.5*np_local) <= 1.e-6*std::abs(sx2));
+}
+
 struct TestParams
 {
     IntVect size;
@@ -551,6 +592,8 @@ void testTransformations ()
     testTwoWayTransform(pc);
 
     testTwoWayFilterAndTransform(pc);
+
+    testTranspose(pc);
     
     amrex::Print() << "pass \n";
 }
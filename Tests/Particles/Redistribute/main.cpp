@@ -412,6 +412,11 @@ void testRedistribute ()
             }
             pc.RedistributeGlobal();
             pc.checkAnswer();
+
+            // the local Redistribute must not reuse buffers set up for the old grids
+            pc.moveParticles(params.move_dir, params.do_random);
+            pc.RedistributeLocal();
+            pc.checkAnswer();
         }
 
         {
@@ -424,7 +429,11 @@ void testRedistribute ()
                 pc.SetParticleDistributionMap(lev, new_dm);
             }
             pc.RedistributeGlobal();
-            pc.checkAnswer();            
+            pc.checkAnswer();
+
+            pc.moveParticles(params.move_dir, params.do_random);
+            pc.RedistributeLocal();
+            pc.checkAnswer();
         }
     }
 
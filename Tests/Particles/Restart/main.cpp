@@ -0,0 +1,209 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleUtil.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+namespace {
+
+static constexpr int NSR = 2;
+static constexpr int NSI = 1;
+static constexpr int NAR = 1;
+static constexpr int NAI = 0;
+
+using PC = ParticleContainer<NSR, NSI, NAR, NAI>;
+
+// num_ppc particles in every cell, with all the real and int data set to the id.
+void initParticles (PC& pc, int num_ppc)
+{
+    const Geometry& geom = pc.Geom(0);
+    const auto plo = geom.ProbLoArray();
+    const auto dx  = geom.CellSizeArray();
+
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi.index(), mfi.LocalTileIndex());
+        for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+        {
+            for (int n = 0; n < num_ppc; ++n)
+            {
+                PC::ParticleType p;
+                p.id()  = PC::ParticleType::NextID();
+                p.cpu() = ParallelDescriptor::MyProc();
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    p.pos(d) = plo[d] + (iv[d] + (n+0.5)/num_ppc)*dx[d];
+                }
+                for (int i = 0; i < NSR; ++i) p.rdata(i) = p.id();
+                for (int i = 0; i < NSI; ++i) p.idata(i) = p.id();
+                std::array<ParticleReal,NAR> soa_real;
+                soa_real.fill(p.id());
+                ptile.push_back(p);
+                ptile.push_back_real(soa_real);
+            }
+        }
+    }
+}
+
+// Move every particle by half the domain in x, without Redistribute, so
+// that none of them is in its grid anymore.
+void moveParticles (PC& pc)
+{
+    const Geometry& geom = pc.Geom(0);
+    const Real plo = geom.ProbLo(0);
+    const Real len = geom.ProbLength(0);
+    for (PC::ParIterType pti(pc, 0); pti.isValid(); ++pti)
+    {
+        auto& aos = pti.GetArrayOfStructs();
+        for (auto& p : aos) {
+            p.pos(0) = plo + std::fmod(p.pos(0) - plo + 0.5*len, len);
+        }
+    }
+}
+
+// The ids of all the particles, sorted, on the I/O rank.
+Vector<Long> gatherIds (const PC& pc)
+{
+    Vector<Long> ids;
+    for (int lev = 0; lev <= pc.finestLevel(); ++lev) {
+        for (PC::ParConstIterType pti(pc, lev); pti.isValid(); ++pti) {
+            for (auto const& p : pti.GetArrayOfStructs()) {
+                ids.push_back(p.id());
+            }
+        }
+    }
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+    const int nlocal = ids.size();
+    Vector<int> counts(nprocs), offsets(nprocs, 0);
+    ParallelDescriptor::Gather(&nlocal, 1, counts.data(), 1, ioproc);
+    for (int i = 1; i < nprocs; ++i) offsets[i] = offsets[i-1] + counts[i-1];
+
+    Vector<Long> all_ids(ParallelDescriptor::IOProcessor() ? offsets[nprocs-1] + counts[nprocs-1] : 0);
+    ParallelDescriptor::Gatherv(ids.data(), nlocal, all_ids.data(), counts, offsets, ioproc);
+    std::sort(all_ids.begin(), all_ids.end());
+    return all_ids;
+}
+
+// Every particle is in the tile it belongs to, has the data it was
+// written with, and the ids are the ones written.
+void checkRestart (const std::string& name, const PC& pc, const Vector<Long>& ids)
+{
+    if (pc.TotalNumberOfParticles() != static_cast<Long>(ids.size()) &&
+        ParallelDescriptor::IOProcessor()) {
+        amrex::Abort(name + ": wrong number of particles");
+    }
+
+    if (numParticlesOutOfRange(pc, 0) != 0) {
+        amrex::Abort(name + ": particles are not in their tiles");
+    }
+
+    bool data_ok = true;
+    for (PC::ParConstIterType pti(pc, 0); pti.isValid(); ++pti)
+    {
+        auto const& aos = pti.GetArrayOfStructs();
+        auto const& soa = pti.GetStructOfArrays();
+        for (int i = 0; i < pti.numParticles(); ++i) {
+            const auto& p = aos[i];
+            for (int n = 0; n < NSR; ++n) data_ok = data_ok && p.rdata(n) == p.id();
+            for (int n = 0; n < NSI; ++n) data_ok = data_ok && p.idata(n) == p.id();
+            for (int n = 0; n < NAR; ++n) data_ok = data_ok && soa.GetRealData(n)[i] == p.id();
+        }
+    }
+    ParallelDescriptor::ReduceBoolAnd(data_ok);
+    if (!data_ok) {
+        amrex::Abort(name + ": the particle data did not round-trip");
+    }
+
+    // The ParIter loops above only see tiles that MFIter visits, so this
+    // also catches particles put in a tile that does not exist.
+    if (gatherIds(pc) != ids) {
+        amrex::Abort(name + ": the particle ids did not round-trip");
+    }
+
+    amrex::Print() << name << ": pass" << (pc.RestartRedistributed() ? " (with Redistribute)" : "") << '\n';
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        ParmParse pp("restart");
+        IntVect size(AMREX_D_DECL(32,32,32));
+        pp.query("size", size);
+        int max_grid_size = 16;
+        pp.query("max_grid_size", max_grid_size);
+        int num_ppc = 2;
+        pp.query("num_ppc", num_ppc);
+
+        RealBox real_box;
+        for (int n = 0; n < AMREX_SPACEDIM; n++) {
+            real_box.setLo(n, 0.0);
+            real_box.setHi(n, 1.0);
+        }
+        const Box domain(IntVect(AMREX_D_DECL(0,0,0)), size - 1);
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+        const Geometry geom(domain, real_box, CoordSys::cartesian, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        const DistributionMapping dm(ba);
+
+        // The same grids, each on the next rank, and on one rank fewer, as
+        // if restarting on a different number of ranks.
+        const int nprocs = ParallelDescriptor::NProcs();
+        Vector<int> pmap = dm.ProcessorMap();
+        for (auto& p : pmap) p = (p + 1) % nprocs;
+        const DistributionMapping dm_shifted(pmap);
+        for (int i = 0; i < pmap.size(); ++i) pmap[i] = i % std::max(nprocs-1, 1);
+        const DistributionMapping dm_fewer(pmap);
+
+        PC pc(geom, dm, ba);
+        initParticles(pc, num_ppc);
+        const Vector<Long> ids = gatherIds(pc);
+        pc.Checkpoint("restart_chk", "particles");
+
+        // Same DistributionMapping: every rank reads back its own grids.
+        {
+            PC pc2(geom, dm, ba);
+            pc2.Restart("restart_chk", "particles");
+            if (pc2.RestartRedistributed()) {
+                amrex::Abort("same DistributionMapping: Restart should not Redistribute");
+            }
+            checkRestart("same DistributionMapping", pc2, ids);
+        }
+
+        // A different DistributionMapping of the same grids: each rank reads
+        // the grids it owns now, so there is still nothing to Redistribute.
+        for (const auto& restart_dm : {dm_shifted, dm_fewer})
+        {
+            PC pc2(geom, restart_dm, ba);
+            pc2.Restart("restart_chk", "particles");
+            if (pc2.RestartRedistributed()) {
+                amrex::Abort("different DistributionMapping: Restart should not Redistribute");
+            }
+            checkRestart("different DistributionMapping", pc2, ids);
+        }
+
+        // Particles written outside of their grids have to be redistributed,
+        // whatever the DistributionMapping.
+        moveParticles(pc);
+        pc.Checkpoint("restart_moved_chk", "particles");
+        for (const auto& restart_dm : {dm, dm_shifted, dm_fewer})
+        {
+            PC pc2(geom, restart_dm, ba);
+            pc2.Restart("restart_moved_chk", "particles");
+            if (!pc2.RestartRedistributed()) {
+                amrex::Abort("moved particles: Restart should Redistribute");
+            }
+            checkRestart("moved particles", pc2, ids);
+        }
+    }
+    amrex::Finalize();
+}
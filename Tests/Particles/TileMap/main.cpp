@@ -0,0 +1,181 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParticleTileMap.H>
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace amrex;
+
+namespace {
+
+using Key = std::pair<int,int>;
+using TileMap = ParticleTileMap<Vector<int> >;
+using RefMap = std::map<Key, Vector<int> >;
+
+// Same keys in the same order, with the same values.
+void checkSame (const std::string& name, const TileMap& tm, const RefMap& ref)
+{
+    if (tm.size() != ref.size()) {
+        amrex::Abort(name + ": wrong size");
+    }
+    auto it = ref.begin();
+    for (auto const& kv : tm) {
+        if (kv.first != it->first || kv.second != it->second) {
+            amrex::Abort(name + ": the tiles differ from std::map");
+        }
+        ++it;
+    }
+}
+
+// Tiles inserted in random order are iterated in key order, and can be
+// found before and after the map is sorted.
+void testInsertOrder ()
+{
+    std::mt19937 gen(42);
+    Vector<Key> keys;
+    for (int grid = 0; grid < 50; ++grid) {
+        for (int tile = 0; tile < 20; ++tile) {
+            keys.push_back(std::make_pair(grid, tile));
+        }
+    }
+    std::shuffle(keys.begin(), keys.end(), gen);
+
+    TileMap tm;
+    RefMap ref;
+    for (int i = 0; i < keys.size(); ++i)
+    {
+        tm[keys[i]].push_back(i);
+        ref[keys[i]].push_back(i);
+        // Look up an earlier tile, which may still be in the unsorted part.
+        const Key& old = keys[i/2];
+        if (tm.count(old) != 1 || tm.at(old) != ref.at(old)) {
+            amrex::Abort("testInsertOrder: lookup during insertion failed");
+        }
+    }
+
+    // insert does not overwrite
+    auto r = tm.insert(std::make_pair(keys[0], Vector<int>{-1}));
+    if (r.second || r.first->second != ref[keys[0]]) {
+        amrex::Abort("testInsertOrder: insert of an existing key");
+    }
+    r = tm.insert(std::make_pair(std::make_pair(1000,0), Vector<int>{7}));
+    ref[std::make_pair(1000,0)] = Vector<int>{7};
+    if (!r.second || r.first->first != std::make_pair(1000,0) || r.first->second != Vector<int>{7}) {
+        amrex::Abort("testInsertOrder: insert of a new key");
+    }
+
+    checkSame("testInsertOrder", tm, ref);
+
+    const TileMap& ctm = tm;
+    for (auto const& kv : ref) {
+        auto it = ctm.find(kv.first);
+        if (it == ctm.end() || it->second != kv.second) {
+            amrex::Abort("testInsertOrder: find failed");
+        }
+    }
+    if (ctm.find(std::make_pair(-1,0)) != ctm.end() || ctm.count(std::make_pair(50,0)) != 0) {
+        amrex::Abort("testInsertOrder: found a key that is not there");
+    }
+    auto lb = tm.lower_bound(std::make_pair(10,5));
+    if (lb == tm.end() || lb->first != std::make_pair(10,5)) {
+        amrex::Abort("testInsertOrder: lower_bound failed");
+    }
+
+    TileMap copy(tm);
+    checkSame("testInsertOrder copy", copy, ref);
+
+    amrex::Print() << "testInsertOrder: " << tm.size() << " tiles inserted in random order\n";
+}
+
+// Erasing while iterating with it = erase(it) visits every tile once.
+void testEraseDuringIteration ()
+{
+    TileMap tm;
+    RefMap ref;
+    for (int grid = 99; grid >= 0; --grid) {
+        for (int tile = 0; tile < 3; ++tile) {
+            tm[std::make_pair(grid,tile)].push_back(grid+tile);
+            ref[std::make_pair(grid,tile)].push_back(grid+tile);
+        }
+    }
+
+    int nvisited = 0;
+    for (auto it = tm.begin(); it != tm.end(); )
+    {
+        ++nvisited;
+        if ((it->first.first + it->first.second) % 2 == 0) {
+            it = tm.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = ref.begin(); it != ref.end(); ) {
+        if ((it->first.first + it->first.second) % 2 == 0) {
+            it = ref.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (nvisited != 300) {
+        amrex::Abort("testEraseDuringIteration: not every tile was visited once");
+    }
+    checkSame("testEraseDuringIteration", tm, ref);
+
+    // New tiles reuse the erased slots and are found in the right place.
+    tm[std::make_pair(4,0)].push_back(1);
+    ref[std::make_pair(4,0)].push_back(1);
+    if (tm.erase(std::make_pair(5,0)) != 1 || tm.erase(std::make_pair(4,2)) != 0) {
+        amrex::Abort("testEraseDuringIteration: erase by key");
+    }
+    ref.erase(std::make_pair(5,0));
+    checkSame("testEraseDuringIteration", tm, ref);
+
+    amrex::Print() << "testEraseDuringIteration: " << tm.size() << " tiles left\n";
+}
+
+// References to tiles stay valid when the map grows by many chunks and
+// when other tiles are erased.
+void testReferences ()
+{
+    TileMap tm;
+    std::map<Key, Vector<int>*> refs;
+    for (int grid = 0; grid < 1000; ++grid) {
+        const Key key = std::make_pair((grid*7919) % 1000, 0);
+        Vector<int>& v = tm[key];
+        v.push_back(key.first);
+        refs[key] = &v;
+        if (&tm[key] != &v) {
+            amrex::Abort("testReferences: a lookup gave a different tile");
+        }
+    }
+    for (auto it = tm.begin(); it != tm.end(); ) {
+        it = (it->first.first % 3 == 0) ? tm.erase(it) : std::next(it);
+    }
+    for (int grid = 1000; grid < 3000; ++grid) {
+        tm[std::make_pair(grid,1)].push_back(grid);
+    }
+    for (auto const& kv : refs)
+    {
+        if (kv.first.first % 3 == 0) continue;
+        if (&tm.at(kv.first) != kv.second || kv.second->size() != 1
+            || (*kv.second)[0] != kv.first.first) {
+            amrex::Abort("testReferences: a reference was invalidated");
+        }
+    }
+    amrex::Print() << "testReferences: references stay valid over " << tm.size() << " tiles\n";
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    testInsertOrder();
+    testEraseDuringIteration();
+    testReferences();
+
+    amrex::Finalize();
+}
@@ -138,6 +138,8 @@ if ( ENABLE_PARTICLES )
       option( ENABLE_DP_PARTICLES "Enable double-precision particle data" ON )
       print_option( ENABLE_DP_PARTICLES )
    endif ()
+   option( ENABLE_PARTICLE_TILE_MAP "Store the particle tiles of a level in a flat tile map" OFF )
+   print_option( ENABLE_PARTICLE_TILE_MAP )
 endif ()
 
 option( ENABLE_SENSEI_INSITU "Enable SENSEI in situ infrastructure" OFF )